@@ -0,0 +1,248 @@
+#include "archive.h"
+#include <cstring>
+#include <filesystem>
+
+#include "mappedFile.h"
+#include "utils/logger.h"
+
+using namespace VDFS;
+
+namespace internal
+{
+  // Layout of the VDF-Header and catalog, see PhysFS' archiver_vdf.c
+  static const size_t   VDF_COMMENT_LENGTH    = 256;
+  static const size_t   VDF_SIGNATURE_LENGTH  = 16;
+  static const size_t   VDF_ENTRY_NAME_LENGTH = 64;
+  static const uint32_t VDF_ENTRY_DIR         = 0x80000000;
+
+  static const char* VDF_SIGNATURE_G1 = "PSVDSC_V2.00\r\n\r\n";
+  static const char* VDF_SIGNATURE_G2 = "PSVDSC_V2.00\n\r\n\r";
+
+#pragma pack(push, 1)
+  struct VdfHeader
+  {
+    char     comment[VDF_COMMENT_LENGTH];
+    char     signature[VDF_SIGNATURE_LENGTH];
+    uint32_t numEntries;
+    uint32_t numFiles;
+    uint32_t timestamp;
+    uint32_t dataSize;
+    uint32_t rootCatOffset;
+    uint32_t version;
+  };
+
+  struct VdfEntry
+  {
+    char     name[VDF_ENTRY_NAME_LENGTH];
+    uint32_t jumpTo;
+    uint32_t size;
+    uint32_t type;
+    uint32_t attributes;
+  };
+#pragma pack(pop)
+}  // namespace internal
+
+std::string VDFS::normalizeMountPoint(const std::string& mountPoint) {
+  size_t begin = 0, end = mountPoint.size();
+  while(begin<end && mountPoint[begin]=='/')
+    ++begin;
+  while(end>begin && mountPoint[end-1]=='/')
+    --end;
+  if(begin==end)
+    return "";
+  return mountPoint.substr(begin,end-begin) + "/";
+  }
+
+static std::shared_ptr<MappedFile> mapVdf(const std::string& path, internal::VdfHeader& header) {
+  // Entries are read positionally, so concurrent readers don't fault in the mapping page by page
+  auto map = MappedFile::open(path,true);
+  if(map==nullptr || map->size()<sizeof(internal::VdfHeader))
+    return nullptr;
+
+  std::memcpy(&header, map->data(), sizeof(header));
+  if(std::memcmp(header.signature, internal::VDF_SIGNATURE_G1, internal::VDF_SIGNATURE_LENGTH)!=0 &&
+     std::memcmp(header.signature, internal::VDF_SIGNATURE_G2, internal::VDF_SIGNATURE_LENGTH)!=0)
+    return nullptr;
+  return map;
+  }
+
+Archive::Archive(EType type, const std::string& path, const std::string& mountPoint)
+  :m_Type(type), m_Path(path), m_MountPoint(normalizeMountPoint(mountPoint)), m_PhysFsMountPoint(mountPoint) {
+  }
+
+Archive::~Archive() {
+  }
+
+std::unique_ptr<Archive> Archive::openVdf(const std::string& path, const std::string& mountPoint) {
+  internal::VdfHeader header = {};
+  auto map = mapVdf(path,header);
+  if(map==nullptr)
+    return nullptr;
+
+  const uint64_t catalogEnd = uint64_t(header.rootCatOffset) + uint64_t(header.numEntries)*sizeof(internal::VdfEntry);
+  if(catalogEnd>map->size()) {
+    LogWarn() << "Corrupt VDF-Catalog in " << path;
+    return nullptr;
+    }
+
+  std::unique_ptr<Archive> ret(new Archive(T_Vdf,path,mountPoint));
+  ret->m_Timestamp = header.timestamp;
+  ret->m_Entries.reserve(header.numFiles);
+  ret->m_EntryByName.reserve(header.numFiles);
+
+  const uint8_t* catalog = map->data() + header.rootCatOffset;
+  for(uint32_t i=0; i<header.numEntries; ++i) {
+    internal::VdfEntry e = {};
+    std::memcpy(&e, catalog + i*sizeof(internal::VdfEntry), sizeof(e));
+    if(e.type & internal::VDF_ENTRY_DIR)
+      continue;
+
+    // Names are padded with spaces
+    size_t len = internal::VDF_ENTRY_NAME_LENGTH;
+    while(len>0 && (e.name[len-1]==' ' || e.name[len-1]=='\0'))
+      --len;
+    if(len==0 || uint64_t(e.jumpTo)+e.size>map->size())
+      continue;
+
+    // Flattened directory structure: first one wins, like in PhysFS
+    Entry entry;
+    entry.name.assign(e.name,len);
+    entry.offset = e.jumpTo;
+    entry.size   = e.size;
+    ret->addEntry(std::move(entry));
+    }
+
+  ret->m_Map = std::move(map);
+  return ret;
+  }
+
+std::unique_ptr<Archive> Archive::openVdfCached(const std::string& path, const std::string& mountPoint,
+                                                uint64_t fileSize, uint32_t timestamp, std::vector<Entry>&& entries) {
+  internal::VdfHeader header = {};
+  auto map = mapVdf(path,header);
+  if(map==nullptr || map->size()!=fileSize || header.timestamp!=timestamp)
+    return nullptr;
+
+  std::unique_ptr<Archive> ret(new Archive(T_Vdf,path,mountPoint));
+  ret->m_Timestamp = header.timestamp;
+  ret->m_Entries.reserve(entries.size());
+  ret->m_EntryByName.reserve(entries.size());
+  for(auto& e:entries) {
+    if(e.offset+e.size>map->size())
+      return nullptr;
+    ret->addEntry(std::move(e));
+    }
+
+  ret->m_Map = std::move(map);
+  return ret;
+  }
+
+std::unique_ptr<Archive> Archive::openFolder(const std::string& path, const std::string& mountPoint) {
+  return std::unique_ptr<Archive>(new Archive(T_Folder,path,mountPoint));
+  }
+
+std::unique_ptr<Archive> Archive::openOther(const std::string& path, const std::string& mountPoint) {
+  return std::unique_ptr<Archive>(new Archive(T_Other,path,mountPoint));
+  }
+
+uint64_t Archive::fileSize() const {
+  return m_Map!=nullptr ? m_Map->size() : 0;
+  }
+
+void Archive::scanFolder() {
+  if(m_Type!=T_Folder)
+    return;
+
+  m_Entries.clear();
+  m_EntryByName.clear();
+
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  const fs::path  root = fs::u8path(m_Path);
+  for(fs::recursive_directory_iterator it(root,ec), end; !ec && it!=end; it.increment(ec)) {
+    // PhysFS doesn't follow symlinks by default, neither do we
+    if(it->is_symlink(ec) || !it->is_regular_file(ec))
+      continue;
+
+    Entry entry;
+    entry.name = it->path().lexically_relative(root).generic_u8string();
+    entry.size = it->file_size(ec);
+    if(ec) {
+      ec.clear();
+      continue;
+      }
+    addEntry(std::move(entry));
+    }
+  }
+
+void Archive::addEntry(Entry&& entry) {
+  std::string key = entry.name;
+  for(auto& c:key)
+    if('a'<=c && c<='z')
+      c = char(c+'A'-'a');
+  if(m_EntryByName.emplace(std::move(key), m_Entries.size()).second)
+    m_Entries.emplace_back(std::move(entry));
+  }
+
+const Archive::Entry* Archive::find(const std::string& name) const {
+  auto it = m_EntryByName.find(name);
+  if(it==m_EntryByName.end())
+    return nullptr;
+  return &m_Entries[it->second];
+  }
+
+FileView Archive::view(const Entry& e) const {
+  return FileView(m_Map, m_Map->data()+e.offset, size_t(e.size), true);
+  }
+
+bool Archive::view(const Entry& e, FileView& view) const {
+  switch(m_Type) {
+    case T_Vdf:
+      view = this->view(e);
+      return true;
+    case T_Folder:
+      return viewLooseFile(e.name,view);
+    case T_Other:
+      break;
+    }
+  return false;
+  }
+
+bool Archive::read(const Entry& e, std::vector<uint8_t>& data) const {
+  data.resize(size_t(e.size));
+  return read(e,0,data.size(),data.data());
+  }
+
+bool Archive::read(const Entry& e, uint64_t offset, size_t size, uint8_t* dest) const {
+  switch(m_Type) {
+    case T_Vdf:
+      // Positional reads, so concurrent readers don't fault in the mapping page by page
+      return m_Map->read(e.offset+offset, dest, size);
+    case T_Folder: {
+      FileView v;
+      if(!viewLooseFile(e.name,v) || offset+size>v.size())
+        return false;
+      if(size>0)
+        std::memcpy(dest, v.data()+offset, size);
+      return true;
+      }
+    case T_Other:
+      break;
+    }
+  return false;
+  }
+
+bool Archive::viewLooseFile(const std::string& name, FileView& view) const {
+  std::string full = m_Path;
+  if(!full.empty() && full.back()!='/' && full.back()!='\\')
+    full.push_back('/');
+  full += name;
+
+  auto map = MappedFile::open(full);
+  if(map==nullptr)
+    return false;
+  auto data = map->data();
+  auto size = map->size();
+  view = FileView(std::move(map), data, size, true);
+  return true;
+  }
@@ -0,0 +1,141 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fileView.h"
+
+namespace VDFS
+{
+    class MappedFile;
+
+    /**
+      * @brief A single archive or folder mounted into the file-index
+      */
+    class Archive
+    {
+    public:
+      enum EType
+      {
+        T_Vdf,
+        T_Folder,
+        T_Other,  // Mounted through PhysFS only (zip, ...), contents unknown to us
+      };
+
+      /**
+        * @brief Location of a file inside an archive
+        */
+      struct Entry
+      {
+        std::string name;  // Relative to the archive root, spelled as stored in the archive
+        uint64_t    offset = 0;
+        uint64_t    size   = 0;
+      };
+
+      Archive(Archive&)=delete;
+      Archive(Archive&&)=delete;
+      ~Archive();
+      Archive& operator=(Archive&)=delete;
+      Archive& operator=(Archive&&)=delete;
+
+      /**
+        * @brief Maps the given VDF-File and reads its directory table
+        * @return nullptr if the file is not a valid VDF or could not be mapped
+        */
+      static std::unique_ptr<Archive> openVdf(const std::string& path, const std::string& mountPoint);
+
+      /**
+        * @brief Maps the given VDF-File, but takes the entries from a cache instead of reading its directory table
+        * @return nullptr if the file could not be mapped or doesn't match the given size and timestamp anymore
+        */
+      static std::unique_ptr<Archive> openVdfCached(const std::string& path, const std::string& mountPoint,
+                                                    uint64_t fileSize, uint32_t timestamp, std::vector<Entry>&& entries);
+
+      /**
+        * @brief Creates a handle for a mounted folder. Files are mapped on demand.
+        */
+      static std::unique_ptr<Archive> openFolder(const std::string& path, const std::string& mountPoint);
+
+      /**
+        * @brief Creates a placeholder for an archive only PhysFS knows how to read
+        */
+      static std::unique_ptr<Archive> openOther(const std::string& path, const std::string& mountPoint);
+
+      /**
+        * @brief Walks a mounted folder and collects all files inside, no-op for other types
+        */
+      void               scanFolder();
+
+      EType              type()       const { return m_Type; }
+      const std::string& path()       const { return m_Path; }
+      const std::string& mountPoint() const { return m_MountPoint; }
+
+      /**
+        * @return size of the archive on disk and the raw timestamp from the VDF-Header, used to validate caches
+        */
+      uint64_t           fileSize()   const;
+      uint32_t           timestamp()  const { return m_Timestamp; }
+
+      /**
+        * @brief Whether PhysFS knows about this archive. Archives loaded from a cache are mounted on demand only.
+        */
+      bool               isPhysFsMounted() const { return m_PhysFsMounted; }
+      void               setPhysFsMounted(bool mounted) { m_PhysFsMounted = mounted; }
+      const std::string& physFsMountPoint() const { return m_PhysFsMountPoint; }
+
+      const std::vector<Entry>& entries() const { return m_Entries; }
+
+      /**
+        * @param name upper-cased filename relative to the archive root
+        * @return nullptr if this archive doesn't contain the file
+        */
+      const Entry* find(const std::string& name) const;
+
+      /**
+        * @return view onto the mapped bytes of the given entry
+        */
+      FileView     view(const Entry& e) const;
+
+      /**
+        * @brief Maps the given entry. Entries of folders are mapped on demand.
+        */
+      bool         view(const Entry& e, FileView& view) const;
+
+      /**
+        * @brief Copies the given entry into data. Safe to call from several threads at once.
+        */
+      bool         read(const Entry& e, std::vector<uint8_t>& data) const;
+
+      /**
+        * @brief Copies size bytes starting at offset inside the given entry. The range must lie inside the entry.
+        */
+      bool         read(const Entry& e, uint64_t offset, size_t size, uint8_t* dest) const;
+
+      /**
+        * @brief Maps a loose file of a mounted folder
+        * @param name path relative to the folder, as found on disk
+        */
+      bool         viewLooseFile(const std::string& name, FileView& view) const;
+
+    private:
+      Archive(EType type, const std::string& path, const std::string& mountPoint);
+
+      void addEntry(Entry&& entry);
+
+      EType                                   m_Type = T_Vdf;
+      std::string                             m_Path;
+      std::string                             m_MountPoint;
+      std::string                             m_PhysFsMountPoint;
+      bool                                    m_PhysFsMounted = false;
+      uint32_t                                m_Timestamp     = 0;
+      std::shared_ptr<MappedFile>             m_Map;
+      std::vector<Entry>                      m_Entries;
+      std::unordered_map<std::string, size_t> m_EntryByName;
+    };
+
+    /**
+      * @brief Converts a PhysFS-style mount point into the prefix of the mounted files ("/" -> "", "/a/b/" -> "a/b/")
+      */
+    std::string normalizeMountPoint(const std::string& mountPoint);
+}  // namespace VDFS
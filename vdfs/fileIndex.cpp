@@ -4,9 +4,16 @@
 #include <fstream>
 #include <iomanip>
 #include <regex>
+#include <stdexcept>
+#include <thread>
 #include <cassert>
 #include <physfs.h>
 #include "../lib/physfs/extras/ignorecase.h"
+#include "archive.h"
+#include "fileStats.h"
+#include "indexCache.h"
+#include "ioPool.h"
+#include "mappedFile.h"
 #include "utils/logger.h"
 
 using namespace VDFS;
@@ -19,6 +26,88 @@ namespace internal
   // We need to do some poor-mans-refcounting to be able to know when we
   // need to init and deinit physfs.
   static size_t numAliveIndices = 0;
+
+  static const uint32_t INVALID_INDEX = uint32_t(-1);
+
+  static char toUpper(char c) {
+    return ('a'<=c && c<='z') ? char(c+'A'-'a') : c;
+    }
+
+  // FNV-1a over the upper-cased name
+  static uint32_t hashName(const char* name, size_t len) {
+    uint32_t h = 2166136261u;
+    for(size_t i=0; i<len; ++i) {
+      h ^= uint8_t(toUpper(name[i]));
+      h *= 16777619u;
+      }
+    return h;
+    }
+
+  // FNV-1a, 64 bit. Never 0, so 0 can mark hashes not computed yet.
+  static uint64_t hashContent(const uint8_t* data, size_t size) {
+    uint64_t h = 14695981039346656037ull;
+    for(size_t i=0; i<size; ++i) {
+      h ^= data[i];
+      h *= 1099511628211ull;
+      }
+    return h!=0 ? h : 1;
+    }
+
+  static bool equalsNoCase(std::string_view a, const char* b, size_t len) {
+    if(a.size()!=len)
+      return false;
+    for(size_t i=0; i<len; ++i)
+      if(toUpper(a[i])!=toUpper(b[i]))
+        return false;
+    return true;
+    }
+
+  static std::string toUpper(const std::string& file) {
+    std::string ret = file;
+    for(auto& c:ret)
+      c = toUpper(c);
+    return ret;
+    }
+
+  // Glob with '*' and '?', ignoring case
+  static bool matchGlob(std::string_view name, std::string_view pattern) {
+    size_t n = 0, p = 0;
+    size_t starP = std::string_view::npos, starN = 0;
+    while(n<name.size()) {
+      if(p<pattern.size() && pattern[p]=='*') {
+        starP = p++;
+        starN = n;
+        }
+      else if(p<pattern.size() && (pattern[p]=='?' || toUpper(pattern[p])==toUpper(name[n]))) {
+        ++p;
+        ++n;
+        }
+      else if(starP!=std::string_view::npos) {
+        // Let the last star eat one more character
+        p = starP+1;
+        n = ++starN;
+        }
+      else {
+        return false;
+        }
+      }
+    while(p<pattern.size() && pattern[p]=='*')
+      ++p;
+    return p==pattern.size();
+    }
+
+  static const char* skipRoot(const char* file) {
+    while(*file=='/')
+      ++file;
+    return file;
+    }
+
+  static std::string_view dirName(const char* file) {
+    std::string_view dir = skipRoot(file);
+    while(!dir.empty() && dir.back()=='/')
+      dir.remove_suffix(1);
+    return dir;
+    }
 }  // namespace internal
 
 FileIndex::FileIndex()
@@ -53,6 +142,9 @@ FileIndex::FileIndex()
 }
 
 FileIndex::~FileIndex() {
+  // Pending prefetches still use the archives
+  m_IoPool.reset();
+
   assert(internal::numAliveIndices != 0);
   internal::numAliveIndices--;
 
@@ -79,23 +171,76 @@ bool FileIndex::loadVDF(const std::u16string &vdf, const std::string &mountPoint
 * @brief Loads a VDF-File and initializes everything
 */
 bool FileIndex::loadVDF(const std::string& vdf, const std::string& mountPoint) {
+  dropIndex();
+
+  // PhysFS would read the whole directory table on mount, so cached archives get mounted on demand only
+  if(m_IndexCache!=nullptr) {
+    if(auto archive = m_IndexCache->open(vdf,mountPoint)) {
+      m_Archives.emplace_back(std::move(archive));
+      return true;
+      }
+    }
+
   if (!PHYSFS_mount(vdf.c_str(), mountPoint.c_str(), 1)) {
     LogInfo() << "Couldn't load VDF-Archive " << vdf << ": " << PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode());
     return false;
     }
 
+  // Map the archive as well, so files can be handed out without copying them.
+  // Anything which isn't a VDF (zip, ...) is only served through PhysFS.
+  auto archive = Archive::openVdf(vdf,mountPoint);
+  if(archive!=nullptr && m_IndexCache!=nullptr)
+    m_IndexCache->markStale();
+  if(archive==nullptr)
+    archive = Archive::openOther(vdf,mountPoint);
+  archive->setPhysFsMounted(true);
+  m_Archives.emplace_back(std::move(archive));
   return true;
   }
 
 bool FileIndex::mountFolder(const std::string& path, const std::string& mountPoint) {
+  dropIndex();
   if (!PHYSFS_mount(path.c_str(), mountPoint.c_str(), 1)) {
     LogInfo() << "Couldn't mount directory " << path << ": " << PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode());
     return false;
     }
 
+  m_Archives.emplace_back(Archive::openFolder(path,mountPoint));
+  m_Archives.back()->setPhysFsMounted(true);
   return true;
   }
 
+void FileIndex::setIndexCache(const std::string& path) {
+  m_IndexCache.reset(new IndexCache(path));
+  }
+
+/**
+* @brief Hands archives loaded from the cache to PhysFS, keeping the order they were loaded in
+*/
+void FileIndex::mountPending() const {
+  size_t first = 0;
+  while(first<m_Archives.size() && m_Archives[first]->isPhysFsMounted())
+    ++first;
+  if(first==m_Archives.size())
+    return;
+
+  // PhysFS can only append, so everything behind the first unmounted archive has to be remounted
+  for(size_t i=first; i<m_Archives.size(); ++i) {
+    Archive& a = *m_Archives[i];
+    if(a.isPhysFsMounted())
+      PHYSFS_unmount(a.path().c_str());
+    a.setPhysFsMounted(false);
+    }
+  for(size_t i=first; i<m_Archives.size(); ++i) {
+    Archive& a = *m_Archives[i];
+    if(!PHYSFS_mount(a.path().c_str(), a.physFsMountPoint().c_str(), 1)) {
+      LogInfo() << "Couldn't mount " << a.path() << ": " << PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode());
+      continue;
+      }
+    a.setPhysFsMounted(true);
+    }
+  }
+
 /**
 * @brief Fills a vector with the data of the given file
 */
@@ -107,6 +252,20 @@ bool FileIndex::getFileData(const std::string& file, std::vector<uint8_t>& data)
 * @brief Fills a vector with the data of the given file
 */
 bool FileIndex::getFileData(const char* file, std::vector<uint8_t>& data) const {
+  const uint64_t start = statsClock();
+  const IndexEntry* e = nullptr;
+  if(resolve(file,e)) {
+    if(e==nullptr) {
+      recordMiss();
+      return false;
+      }
+    const uint64_t opened = statsClock();
+    if(!readIndexed(*e,data))
+      return false;
+    recordRead(e,data.size(),start,opened,false);
+    return true;
+    }
+
   std::string upperedStr;
   char        upperedC[64] = {};
   char*       uppered      = (char*)upperedC;
@@ -124,10 +283,15 @@ bool FileIndex::getFileData(const char* file, std::vector<uint8_t>& data) const
       uppered[i] = char(c+'A'-'a');
     }
 
+  std::lock_guard<std::mutex> guard(m_PhysFsSync);
+  mountPending();
   PHYSFS_File* handle = PHYSFS_openRead(uppered);
-  if(handle==nullptr)
-      return false;
+  if(handle==nullptr) {
+    recordMiss();
+    return false;
+    }
 
+  const uint64_t opened = statsClock();
   auto length = PHYSFS_fileLength(handle);
   data.resize(length);
   if (PHYSFS_readBytes(handle, data.data(), length) < length) {
@@ -136,14 +300,34 @@ bool FileIndex::getFileData(const char* file, std::vector<uint8_t>& data) const
     return false;
     }
   PHYSFS_close(handle);
+  recordRead(nullptr,data.size(),start,opened,false);
   return true;
   }
 
 bool FileIndex::getFileDataSameCase(const char* file, std::vector<uint8_t>& data) const {
-  PHYSFS_File* handle = PHYSFS_openRead(file);
-  if(handle==nullptr)
+  const uint64_t start = statsClock();
+  const IndexEntry* e = nullptr;
+  if(resolve(file,e)) {
+    if(e==nullptr || nameOf(*e)!=internal::skipRoot(file)) {
+      recordMiss();
       return false;
+      }
+    const uint64_t opened = statsClock();
+    if(!readIndexed(*e,data))
+      return false;
+    recordRead(e,data.size(),start,opened,false);
+    return true;
+    }
+
+  std::lock_guard<std::mutex> guard(m_PhysFsSync);
+  mountPending();
+  PHYSFS_File* handle = PHYSFS_openRead(file);
+  if(handle==nullptr) {
+    recordMiss();
+    return false;
+    }
 
+  const uint64_t opened = statsClock();
   auto length = PHYSFS_fileLength(handle);
   data.resize(length);
   if (PHYSFS_readBytes(handle, data.data(), length) < length) {
@@ -152,10 +336,223 @@ bool FileIndex::getFileDataSameCase(const char* file, std::vector<uint8_t>& data
     return false;
     }
   PHYSFS_close(handle);
+  recordRead(nullptr,data.size(),start,opened,false);
+  return true;
+  }
+
+int64_t FileIndex::getFileSize(const std::string& file) const {
+  const IndexEntry* e = nullptr;
+  if(resolve(file.c_str(),e))
+    return e!=nullptr ? int64_t(e->size) : -1;
+
+  std::lock_guard<std::mutex> guard(m_PhysFsSync);
+  mountPending();
+  PHYSFS_Stat st={};
+  if(PHYSFS_stat(internal::toUpper(file).c_str(),&st)==0 || st.filetype!=PHYSFS_FILETYPE_REGULAR)
+    return -1;
+  return st.filesize;
+  }
+
+bool FileIndex::getFileRange(const std::string& file, uint64_t offset, size_t length, std::vector<uint8_t>& data) const {
+  const uint64_t start = statsClock();
+  const IndexEntry* e = nullptr;
+  if(resolve(file.c_str(),e)) {
+    if(e==nullptr) {
+      recordMiss();
+      return false;
+      }
+    if(offset>e->size)
+      return false;
+    const uint64_t opened = statsClock();
+    data.resize(size_t(std::min<uint64_t>(length,e->size-offset)));
+    const Archive& archive = *m_Archives[e->archive];
+    if(!archive.read(archive.entries()[e->entry],offset,data.size(),data.data()))
+      return false;
+    recordRead(e,data.size(),start,opened,false);
+    return true;
+    }
+
+  std::lock_guard<std::mutex> guard(m_PhysFsSync);
+  mountPending();
+  PHYSFS_File* handle = PHYSFS_openRead(internal::toUpper(file).c_str());
+  if(handle==nullptr) {
+    recordMiss();
+    return false;
+    }
+  const uint64_t opened = statsClock();
+
+  const auto fileLength = PHYSFS_fileLength(handle);
+  if(fileLength<0 || offset>uint64_t(fileLength) || !PHYSFS_seek(handle,offset)) {
+    PHYSFS_close(handle);
+    return false;
+    }
+
+  data.resize(size_t(std::min<uint64_t>(length,uint64_t(fileLength)-offset)));
+  if (PHYSFS_readBytes(handle, data.data(), data.size()) < PHYSFS_sint64(data.size())) {
+    LogInfo() << "Cannot read file " << file << ": " << PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode());
+    PHYSFS_close(handle);
+    return false;
+    }
+  PHYSFS_close(handle);
+  recordRead(nullptr,data.size(),start,opened,false);
+  return true;
+  }
+
+bool FileIndex::getFileView(const std::string& file, FileView& view) const {
+  const uint64_t start = statsClock();
+  const IndexEntry* e = nullptr;
+  if(resolve(file.c_str(),e)) {
+    if(e==nullptr) {
+      recordMiss();
+      return false;
+      }
+    const uint64_t opened = statsClock();
+    if(!viewIndexed(*e,view))
+      return false;
+    recordRead(e,view.size(),start,opened,view.isMapped());
+    return true;
+    }
+
+  const std::string uppered = internal::toUpper(file);
+
+  // Ask PhysFS which of the mounted archives wins for this file
+  std::unique_lock<std::mutex> guard(m_PhysFsSync);
+  mountPending();
+  const char* realDir = PHYSFS_getRealDir(uppered.c_str());
+  if(realDir==nullptr) {
+    recordMiss();
+    return false;
+    }
+  const Archive* archive = findArchive(realDir);
+  guard.unlock();
+  const uint64_t opened = statsClock();
+
+  if(archive!=nullptr) {
+    size_t begin = 0;
+    while(begin<uppered.size() && uppered[begin]=='/')
+      ++begin;
+
+    const std::string& mp = archive->mountPoint();
+    if(uppered.compare(begin,mp.size(),mp)==0) {
+      const std::string name = uppered.substr(begin+mp.size());
+      if(archive->type()==Archive::T_Vdf) {
+        if(auto e = archive->find(name)) {
+          view = archive->view(*e);
+          recordRead(nullptr,view.size(),start,opened,true);
+          return true;
+          }
+        }
+      else if(archive->viewLooseFile(name,view)) {
+        recordRead(nullptr,view.size(),start,opened,view.isMapped());
+        return true;
+        }
+      }
+    }
+
+  std::vector<uint8_t> data;
+  if(!getFileData(file,data))
+    return false;
+  view = FileView(std::move(data));
   return true;
   }
 
+void FileIndex::prefetch(const std::vector<std::string>& names, PrefetchCallback callback) const {
+  auto shared = std::make_shared<const std::vector<std::string>>(names);
+  auto cb     = std::make_shared<PrefetchCallback>(std::move(callback));
+  schedulePrefetch(shared,[shared,cb](size_t idx, bool found, FileView&& view){
+    (*cb)((*shared)[idx],found,std::move(view));
+    });
+  }
+
+std::vector<std::future<FileView>> FileIndex::prefetch(const std::vector<std::string>& names) const {
+  auto shared   = std::make_shared<const std::vector<std::string>>(names);
+  auto promises = std::make_shared<std::vector<std::promise<FileView>>>(names.size());
+
+  std::vector<std::future<FileView>> ret;
+  ret.reserve(names.size());
+  for(auto& p:*promises)
+    ret.emplace_back(p.get_future());
+
+  schedulePrefetch(shared,[shared,promises](size_t idx, bool found, FileView&& view){
+    if(found)
+      (*promises)[idx].set_value(std::move(view));
+    else
+      (*promises)[idx].set_exception(std::make_exception_ptr(std::runtime_error("File not found: " + (*shared)[idx])));
+    });
+  return ret;
+  }
+
+void FileIndex::schedulePrefetch(std::shared_ptr<const std::vector<std::string>> names,
+                                 std::function<void(size_t, bool, FileView&&)> done) const {
+  struct Request
+  {
+    size_t   name;
+    uint32_t archive;
+    uint64_t offset;
+  };
+
+  // Sort by position on disk. Files the index doesn't know go last, in the order given.
+  std::vector<Request> requests(names->size());
+  for(size_t i=0; i<names->size(); ++i) {
+    const IndexEntry* e = nullptr;
+    requests[i].name    = i;
+    requests[i].archive = uint32_t(-1);
+    requests[i].offset  = 0;
+    if(resolve((*names)[i].c_str(),e) && e!=nullptr) {
+      requests[i].archive = e->archive;
+      requests[i].offset  = e->offset;
+      }
+    }
+  std::stable_sort(requests.begin(),requests.end(),[](const Request& a, const Request& b){
+    return a.archive<b.archive || (a.archive==b.archive && a.offset<b.offset);
+    });
+
+  auto cb = std::make_shared<std::function<void(size_t, bool, FileView&&)>>(std::move(done));
+  std::vector<std::function<void()>> jobs;
+  jobs.reserve(requests.size());
+  for(auto& r:requests) {
+    const size_t idx = r.name;
+    jobs.emplace_back([this,names,cb,idx](){
+      const std::string& name = (*names)[idx];
+      FileView view;
+      const bool found = getFileView(name,view);
+      if(found && view.isMapped())
+        MappedFile::willNeed(view.data(),view.size());
+      try {
+        (*cb)(idx,found,std::move(view));
+        }
+      catch(const std::exception& e) {
+        LogError() << "Prefetch callback for " << name << " failed: " << e.what();
+        }
+      });
+    }
+  ioPool().push(std::move(jobs));
+  }
+
+IoPool& FileIndex::ioPool() const {
+  std::lock_guard<std::mutex> guard(m_IoPoolSync);
+  if(m_IoPool==nullptr) {
+    // A few threads are enough to keep the disk busy
+    size_t numThreads = std::thread::hardware_concurrency();
+    numThreads = std::max<size_t>(1,std::min<size_t>(4,numThreads));
+    m_IoPool.reset(new IoPool(numThreads));
+    }
+  return *m_IoPool;
+  }
+
+const Archive* FileIndex::findArchive(const char* realDir) const {
+  for(auto& a:m_Archives)
+    if(a->path()==realDir)
+      return a.get();
+  return nullptr;
+  }
+
 bool FileIndex::hasFile(const std::string& file) const {
+  const IndexEntry* e = nullptr;
+  std::string_view  dir;
+  if(resolve(file.c_str(),e))
+    return e!=nullptr || findDirectory(internal::dirName(file.c_str()),dir);
+
   std::string upperedStr;
   char        upperedC[64] = {};
   char*       uppered      = (char*)upperedC;
@@ -172,11 +569,22 @@ bool FileIndex::hasFile(const std::string& file) const {
     if('a'<=c && c<='z')
       uppered[i] = char(c+'A'-'a');
     }
+  std::lock_guard<std::mutex> guard(m_PhysFsSync);
+  mountPending();
   PHYSFS_Stat st={};
   return PHYSFS_stat(uppered,&st)!=0;
   }
 
 bool FileIndex::hasFileCaseSensitive(const std::string& file) const {
+  const IndexEntry* e = nullptr;
+  std::string_view  dir;
+  if(resolve(file.c_str(),e)) {
+    if(e!=nullptr)
+      return nameOf(*e)==internal::skipRoot(file.c_str());
+    const std::string_view name = internal::dirName(file.c_str());
+    return findDirectory(name,dir) && dir==name;
+    }
+
   std::string upperedStr;
   char        upperedC[64] = {};
   char*       uppered      = (char*)upperedC;
@@ -188,6 +596,8 @@ bool FileIndex::hasFileCaseSensitive(const std::string& file) const {
     uppered    = &upperedStr[0];
     }
 
+  std::lock_guard<std::mutex> guard(m_PhysFsSync);
+  mountPending();
   PHYSFS_Stat st={};
   return PHYSFS_stat(uppered,&st)!=0;
   }
@@ -234,7 +644,91 @@ int64_t VDFS::FileIndex::getLastModTime(const std::string& name) {
   return result;
   }
 
+std::vector<std::string_view> FileIndex::findFiles(const std::string& pattern) const {
+  std::vector<std::string_view> ret;
+  const std::string_view glob = internal::skipRoot(pattern.c_str());
+  for(auto& e:m_Index) {
+    auto name = nameOf(e);
+    if(internal::matchGlob(name,glob))
+      ret.push_back(name);
+    }
+  return ret;
+  }
+
+std::vector<std::string_view> FileIndex::findFilesByExtension(const std::string& ext) const {
+  std::string suffix = ext;
+  if(suffix.empty() || suffix[0]!='.')
+    suffix.insert(suffix.begin(),'.');
+
+  std::vector<std::string_view> ret;
+  for(auto& e:m_Index) {
+    auto name = nameOf(e);
+    if(name.size()>=suffix.size() &&
+       internal::equalsNoCase(name.substr(name.size()-suffix.size()),suffix.c_str(),suffix.size()))
+      ret.push_back(name);
+    }
+  return ret;
+  }
+
+std::vector<FileIndex::ShadowedFile> FileIndex::getShadowedFiles(bool compareContents) const {
+  std::vector<ShadowedFile> ret(m_Shadowed.size());
+  for(size_t i=0; i<m_Shadowed.size(); ++i) {
+    const ShadowEntry& s      = m_Shadowed[i];
+    const IndexEntry&  winner = m_Index[s.winner];
+    const Archive&     hidden = *m_Archives[s.archive];
+    const auto&        entry  = hidden.entries()[s.entry];
+
+    ShadowedFile& f = ret[i];
+    f.name         = nameOf(winner);
+    f.winner       = m_Archives[winner.archive]->path();
+    f.shadowed     = hidden.path();
+    f.winnerSize   = winner.size;
+    f.shadowedSize = entry.size;
+
+    if(!compareContents || winner.size!=entry.size)
+      continue;
+    uint64_t winnerHash = 0;
+    FileView view;
+    if(!getContentHash(std::string(f.name),winnerHash) || !hidden.view(entry,view))
+      continue;
+    f.identical = internal::hashContent(view.data(),view.size())==winnerHash;
+    }
+  return ret;
+  }
+
+bool FileIndex::getContentHash(const std::string& file, uint64_t& hash) const {
+  const IndexEntry* e = nullptr;
+  if(!resolve(file.c_str(),e)) {
+    // An archive only PhysFS can read might win, hash whatever getFileView() serves without caching it
+    FileView view;
+    if(!getFileView(file,view))
+      return false;
+    hash = internal::hashContent(view.data(),view.size());
+    return true;
+    }
+  if(e==nullptr)
+    return false;
+
+  // Racing threads compute the same value, so whoever stores last doesn't matter
+  std::atomic<uint64_t>& cached = m_ContentHashes[size_t(e-m_Index.data())];
+  hash = cached.load(std::memory_order_relaxed);
+  if(hash!=0) {
+    if(m_Stats!=nullptr)
+      m_Stats->recordHit(size_t(e-m_Index.data()),e->archive);
+    return true;
+    }
+
+  FileView view;
+  if(!viewIndexed(*e,view))
+    return false;
+  hash = internal::hashContent(view.data(),view.size());
+  cached.store(hash,std::memory_order_relaxed);
+  return true;
+  }
+
 std::vector<std::string> FileIndex::getKnownFiles(const std::string& path) const {
+  std::lock_guard<std::mutex> guard(m_PhysFsSync);
+  mountPending();
   std::string filePath(path);
   std::vector<std::string> vec;
   bool exists = PHYSFSEXT_locateCorrectCase(&filePath[0]) == 0;
@@ -249,6 +743,207 @@ std::vector<std::string> FileIndex::getKnownFiles(const std::string& path) const
   return vec;
   }
 
-void FileIndex::finalizeLoad()
-{
-}
+void FileIndex::finalizeLoad() {
+  dropIndex();
+
+  size_t count     = 0;
+  size_t nameBytes = 0;
+  for(auto& a:m_Archives) {
+    a->scanFolder();
+    count += a->entries().size();
+    for(auto& e:a->entries())
+      nameBytes += a->mountPoint().size() + e.name.size();
+    }
+
+  size_t numSlots = 16;
+  while(numSlots<count*2)
+    numSlots *= 2;
+  m_Index.reserve(count);
+  m_IndexSlots.assign(numSlots,internal::INVALID_INDEX);
+  m_Names.reserve(nameBytes);
+
+  const size_t mask = numSlots-1;
+  for(uint32_t i=0; i<m_Archives.size(); ++i) {
+    const Archive& archive = *m_Archives[i];
+    if(archive.type()==Archive::T_Other && m_FirstOther==internal::INVALID_INDEX)
+      m_FirstOther = i;
+
+    auto& entries = archive.entries();
+    for(uint32_t r=0; r<entries.size(); ++r) {
+      IndexEntry e;
+      e.nameOffset = uint32_t(m_Names.size());
+      m_Names     += archive.mountPoint();
+      m_Names     += entries[r].name;
+      e.nameLength = uint32_t(m_Names.size()-e.nameOffset);
+
+      const char* name = m_Names.c_str()+e.nameOffset;
+      e.hash    = internal::hashName(name,e.nameLength);
+      e.archive = i;
+      e.entry   = r;
+      e.offset  = entries[r].offset;
+      e.size    = entries[r].size;
+
+      // Archives mounted first take precedence, same as in PhysFS
+      size_t slot = e.hash & mask;
+      bool   shadowed = false;
+      for(; m_IndexSlots[slot]!=internal::INVALID_INDEX; slot=(slot+1)&mask) {
+        const IndexEntry& other = m_Index[m_IndexSlots[slot]];
+        if(other.hash==e.hash && internal::equalsNoCase(nameOf(other),name,e.nameLength)) {
+          shadowed = true;
+          break;
+          }
+        }
+      if(shadowed) {
+        m_Shadowed.push_back({m_IndexSlots[slot],i,r});
+        m_Names.resize(e.nameOffset);
+        continue;
+        }
+      m_IndexSlots[slot] = uint32_t(m_Index.size());
+      m_Index.emplace_back(e);
+      }
+    }
+
+  // Directories only exist through the files in them. Files of one directory mostly come in a row.
+  std::string_view lastDir;
+  for(auto& e:m_Index) {
+    const std::string_view name = nameOf(e);
+    const size_t           end  = name.rfind('/');
+    if(end==std::string_view::npos || name.substr(0,end)==lastDir)
+      continue;
+    lastDir = name.substr(0,end);
+    for(size_t i=name.find('/'); i!=std::string_view::npos && i<=end; i=name.find('/',i+1)) {
+      if(i>0)
+        m_Dirs.emplace(internal::toUpper(std::string(name.substr(0,i))),name.substr(0,i));
+      }
+    }
+
+  m_ContentHashes.reset(new std::atomic<uint64_t>[m_Index.size()]);
+  for(size_t i=0; i<m_Index.size(); ++i)
+    m_ContentHashes[i] = 0;
+  m_Finalized = true;
+  if(m_Stats!=nullptr)
+    m_Stats.reset(new FileStats(m_Index.size(),m_Archives.size()));
+
+  if(m_IndexCache!=nullptr && m_IndexCache->isStale())
+    m_IndexCache->write(m_Archives);
+  }
+
+void FileIndex::dropIndex() {
+  m_Index.clear();
+  m_IndexSlots.clear();
+  m_Names.clear();
+  m_Shadowed.clear();
+  m_Dirs.clear();
+  m_ContentHashes.reset();
+  m_Finalized  = false;
+  m_FirstOther = internal::INVALID_INDEX;
+  if(m_Stats!=nullptr)
+    m_Stats.reset(new FileStats(0,m_Archives.size()));
+  }
+
+const FileIndex::IndexEntry* FileIndex::findIndexed(const char* file) const {
+  if(m_IndexSlots.empty())
+    return nullptr;
+
+  file = internal::skipRoot(file);
+  const size_t   len  = std::strlen(file);
+  const uint32_t hash = internal::hashName(file,len);
+  const size_t   mask = m_IndexSlots.size()-1;
+  for(size_t slot=hash&mask; m_IndexSlots[slot]!=internal::INVALID_INDEX; slot=(slot+1)&mask) {
+    const IndexEntry& e = m_Index[m_IndexSlots[slot]];
+    if(e.hash==hash && internal::equalsNoCase(nameOf(e),file,len))
+      return &e;
+    }
+  return nullptr;
+  }
+
+/**
+* @brief Looks the directory up in the index. The root always exists.
+*/
+bool FileIndex::findDirectory(std::string_view dir, std::string_view& spelled) const {
+  if(dir.empty()) {
+    spelled = dir;
+    return true;
+    }
+  auto it = m_Dirs.find(internal::toUpper(std::string(dir)));
+  if(it==m_Dirs.end())
+    return false;
+  spelled = it->second;
+  return true;
+  }
+
+/**
+* @brief Looks the file up in the index
+* @return false, if the index can't answer this and PhysFS has to be asked instead
+*/
+bool FileIndex::resolve(const char* file, const IndexEntry*& entry) const {
+  if(!m_Finalized)
+    return false;
+  entry = findIndexed(file);
+
+  // Archives only PhysFS can read might contain or shadow this file
+  const uint32_t priority = entry!=nullptr ? entry->archive : uint32_t(m_Archives.size());
+  return m_FirstOther>priority;
+  }
+
+bool FileIndex::readIndexed(const IndexEntry& e, std::vector<uint8_t>& data) const {
+  const Archive& archive = *m_Archives[e.archive];
+  return archive.read(archive.entries()[e.entry],data);
+  }
+
+bool FileIndex::viewIndexed(const IndexEntry& e, FileView& view) const {
+  const Archive& archive = *m_Archives[e.archive];
+  return archive.view(archive.entries()[e.entry],view);
+  }
+
+void FileIndex::enableStats(bool enable) {
+  if(!enable)
+    m_Stats.reset();
+  else if(m_Stats==nullptr)
+    m_Stats.reset(new FileStats(m_Index.size(),m_Archives.size()));
+  }
+
+void FileIndex::resetStats() {
+  if(m_Stats!=nullptr)
+    m_Stats->reset();
+  }
+
+bool FileIndex::writeStats(std::ostream& out, EStatsFormat format) const {
+  if(m_Stats==nullptr)
+    return false;
+
+  // The PhysFS-slot of the stats has no name
+  std::vector<std::string_view> files(m_Index.size());
+  std::vector<uint32_t>         fileArchive(m_Index.size());
+  std::vector<std::string_view> archives(m_Archives.size());
+  for(size_t i=0; i<m_Index.size(); ++i) {
+    files[i]       = nameOf(m_Index[i]);
+    fileArchive[i] = m_Index[i].archive;
+    }
+  for(size_t i=0; i<m_Archives.size(); ++i)
+    archives[i] = m_Archives[i]->path();
+
+  if(format==SF_Json)
+    m_Stats->writeJson(out,files,fileArchive,archives);
+  else
+    m_Stats->writeCsv(out,files,fileArchive,archives);
+  return bool(out);
+  }
+
+uint64_t FileIndex::statsClock() const {
+  return m_Stats!=nullptr ? FileStats::now() : 0;
+  }
+
+void FileIndex::recordRead(const IndexEntry* e, uint64_t bytes, uint64_t start, uint64_t opened, bool mapped) const {
+  if(m_Stats==nullptr)
+    return;
+  if(e!=nullptr)
+    m_Stats->record(size_t(e-m_Index.data()),e->archive,bytes,start,opened,mapped);
+  else
+    m_Stats->recordUnindexed(bytes,start,opened,mapped);
+  }
+
+void FileIndex::recordMiss() const {
+  if(m_Stats!=nullptr)
+    m_Stats->recordMiss();
+  }
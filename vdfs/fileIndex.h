@@ -1,12 +1,31 @@
 #pragma once
+#include <functional>
+#include <future>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
 #include <set>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "fileView.h"
+
 namespace VDFS
 {
+    class Archive;
+    class FileStats;
+    class IndexCache;
+    class IoPool;
+
+    /**
+      * @brief Index over all mounted archives and folders.
+      *        Once finalizeLoad() was called, the const methods may be called from several threads at once.
+      *        Mounting and finalizing must not run concurrently to anything else.
+      */
     class FileIndex
     {
     public:
@@ -22,6 +41,14 @@ namespace VDFS
         */
       static void initVDFS(const char* argv0);
 
+      /**
+        * @brief Enables the on-disk cache of VDF directory tables. Must be called before loading any VDF.
+        *        Archives found unchanged in the cache are loaded without reading their directory table,
+        *        finalizeLoad() rewrites the cache if any were missing or outdated.
+        * @param path cache-file to use, created if missing
+        */
+      void setIndexCache(const std::string& path);
+
       /**
         * @brief Loads a VDF-File and initializes everything
         */
@@ -37,6 +64,8 @@ namespace VDFS
 
       /**
         * Must be called after you have mounted/loaded all files. Otherwise files won't be openable.
+        * Builds the lookup-table of all files, so opening them doesn't need to walk every archive.
+        * Mounting something afterwards drops the table until this is called again.
         */
       void finalizeLoad();
 
@@ -55,13 +84,91 @@ namespace VDFS
         */
       bool getFileDataSameCase(const char* file, std::vector<uint8_t>& data) const;
 
+      /**
+        * @return size of the given file in bytes, -1 if it doesn't exist
+        */
+      int64_t getFileSize(const std::string& file) const;
+
+      /**
+        * @brief Reads only the given range of a file, e.g. to look at a header. The range is clamped to the end of the file.
+        * @return false if the file doesn't exist or offset lies past its end
+        */
+      bool getFileRange(const std::string& file, uint64_t offset, size_t length, std::vector<uint8_t>& data) const;
+
+      /**
+        * @brief Returns a read-only view of the given file without copying it. The view is
+        *        mapped straight from the archive or loose file and falls back to an owned
+        *        buffer if mapping is not possible. It stays valid after the index is gone.
+        */
+      bool getFileView(const std::string& file, FileView& view) const;
+
+      /**
+        * @brief Called once a prefetched file is ready, from one of the IO-threads.
+        * @param name as passed to prefetch()
+        * @param found false if the file doesn't exist, view is empty then
+        */
+      using PrefetchCallback = std::function<void(const std::string& name, bool found, FileView&& view)>;
+
+      /**
+        * @brief Loads the given files in the background, so parsing can overlap with IO.
+        *        Requests are sorted by archive and offset, so the archives are read front to back.
+        *        Mapped files have all their pages faulted in by the time the callback runs.
+        */
+      void prefetch(const std::vector<std::string>& names, PrefetchCallback callback) const;
+
+      /**
+        * @brief Same as above, with a future per name in the order given.
+        *        Missing files make their future throw a std::runtime_error.
+        */
+      std::vector<std::future<FileView>> prefetch(const std::vector<std::string>& names) const;
+
+      /**
+        * @brief Lists all indexed files matching the given glob-pattern, ignoring case. '*' matches any
+        *        number of characters, '?' a single one. The views point into the index and stay valid
+        *        until something new is mounted. Requires finalizeLoad(), files only PhysFS can read are not listed.
+        */
+      std::vector<std::string_view> findFiles(const std::string& pattern) const;
+
+      /**
+        * @brief Lists all indexed files with the given extension, e.g. "MAN" or ".man". Same rules as findFiles().
+        */
+      std::vector<std::string_view> findFilesByExtension(const std::string& ext) const;
+
+      /**
+        * @brief A file hidden by the copy of an archive mounted earlier
+        */
+      struct ShadowedFile
+      {
+        std::string_view name;             // Points into the index, same rules as findFiles()
+        std::string_view winner;           // Path of the archive providing the file
+        std::string_view shadowed;         // Path of the archive whose copy is hidden
+        uint64_t         winnerSize   = 0;
+        uint64_t         shadowedSize = 0;
+        bool             identical    = false;  // Only filled in if contents were compared
+      };
+
+      /**
+        * @brief Lists every file mounted more than once, as resolved by finalizeLoad().
+        * @param compareContents hash both copies to tell which ones are identical. Reads all affected files.
+        */
+      std::vector<ShadowedFile> getShadowedFiles(bool compareContents = false) const;
+
+      /**
+        * @brief 64-bit hash of the contents of the given file, computed on first use and kept in the index.
+        *        Lets identical files from different archives share entries in caches built on top.
+        *        Hashes the same copy getFileView() serves. Files which an archive only PhysFS can read
+        *        might shadow are hashed on every call.
+        * @return false if the file doesn't exist or couldn't be read
+        */
+      bool getContentHash(const std::string& file, uint64_t& hash) const;
+
       /**
         * @brief Returnst the list of all known files
         */
       std::vector<std::string> getKnownFiles(const std::string& path = "/") const;
 
       /**
-        * @return Whether a file with the given name exists
+        * @return Whether a file or directory with the given name exists
         */
       bool hasFile(const std::string& name) const;
       
@@ -79,5 +186,115 @@ namespace VDFS
         */
       static int64_t getLastModTime(const std::u16string& name);
       static int64_t getLastModTime(const std::string& name);
+
+      enum EStatsFormat
+      {
+        SF_Json,
+        SF_Csv,
+      };
+
+      /**
+        * @brief Turns counting of reads on or off. Counts reads, bytes, mapped views, hits of the cached
+        *        content-hashes and time spent per file, plus latency-histograms per archive.
+        *        Must not run concurrently to reads.
+        *        The counters start over whenever something is mounted or finalizeLoad() runs.
+        */
+      void enableStats(bool enable);
+      const FileStats* stats() const { return m_Stats.get(); }
+      void resetStats();
+
+      /**
+        * @brief Writes the counters of all archives and of every file read at least once
+        * @return false if stats are not enabled or writing failed
+        */
+      bool writeStats(std::ostream& out, EStatsFormat format = SF_Json) const;
+
+    private:
+      /**
+        * @brief Entry of the lookup-table built by finalizeLoad()
+        */
+      struct IndexEntry
+      {
+        uint32_t    nameOffset = 0;  // Full path including the mount point, inside m_Names
+        uint32_t    nameLength = 0;
+        uint32_t    hash    = 0;  // Case-insensitive hash of the name
+        uint32_t    archive = 0;  // Index into m_Archives, also the priority: lower ones shadow higher ones
+        uint32_t    entry   = 0;  // Index into the entries of the archive
+        uint64_t    offset  = 0;
+        uint64_t    size    = 0;
+      };
+
+      /**
+        * @brief Copy of a file hidden by the entry m_Index[winner]
+        */
+      struct ShadowEntry
+      {
+        uint32_t    winner  = 0;
+        uint32_t    archive = 0;
+        uint32_t    entry   = 0;
+      };
+
+      const Archive*    findArchive(const char* realDir) const;
+      const IndexEntry* findIndexed(const char* file) const;
+      bool              findDirectory(std::string_view dir, std::string_view& spelled) const;
+      std::string_view  nameOf(const IndexEntry& e) const { return std::string_view(m_Names).substr(e.nameOffset,e.nameLength); }
+      bool              resolve(const char* file, const IndexEntry*& entry) const;
+      bool              viewIndexed(const IndexEntry& e, FileView& view) const;
+      bool              readIndexed(const IndexEntry& e, std::vector<uint8_t>& data) const;
+      void              dropIndex();
+      IoPool&           ioPool() const;
+      void              mountPending() const;
+      uint64_t          statsClock() const;
+      void              recordRead(const IndexEntry* e, uint64_t bytes, uint64_t start, uint64_t opened, bool mapped) const;
+      void              recordMiss() const;
+      void              schedulePrefetch(std::shared_ptr<const std::vector<std::string>> names,
+                                         std::function<void(size_t, bool, FileView&&)> done) const;
+
+      /**
+        * @brief Archives and folders in the order they were mounted
+        */
+      std::vector<std::unique_ptr<Archive>> m_Archives;
+
+      /**
+        * @brief Case-insensitive lookup-table over all mounted files. The slots hold indices into
+        *        m_Index and are probed linearly.
+        */
+      std::vector<IndexEntry> m_Index;
+      std::vector<uint32_t>   m_IndexSlots;
+      std::string             m_Names;  // All names of m_Index back to back, never reallocated after finalizeLoad()
+      std::vector<ShadowEntry> m_Shadowed;
+
+      /**
+        * @brief Directories holding indexed files, upper-cased, to their spelling in m_Names
+        */
+      std::unordered_map<std::string,std::string_view> m_Dirs;
+
+      /**
+        * @brief Content-hash per entry of m_Index, 0 until computed
+        */
+      std::unique_ptr<std::atomic<uint64_t>[]> m_ContentHashes;
+      bool                    m_Finalized  = false;
+      uint32_t                m_FirstOther = uint32_t(-1);  // First archive we can only access through PhysFS
+
+      /**
+        * @brief Guards everything going through PhysFS. Lookups served from the index don't lock.
+        */
+      mutable std::mutex      m_PhysFsSync;
+
+      /**
+        * @brief Optional cache of the VDF directory tables
+        */
+      std::unique_ptr<IndexCache> m_IndexCache;
+
+      /**
+        * @brief Read-counters, only allocated while enabled
+        */
+      std::unique_ptr<FileStats> m_Stats;
+
+      /**
+        * @brief Threads serving prefetch(), started on first use
+        */
+      mutable std::mutex              m_IoPoolSync;
+      mutable std::unique_ptr<IoPool> m_IoPool;
     };
 }  // namespace VDFS
@@ -0,0 +1,195 @@
+#include "fileStats.h"
+#include <chrono>
+
+using namespace VDFS;
+
+namespace internal
+{
+  static void add(std::atomic<uint64_t>& counter, uint64_t v) {
+    counter.fetch_add(v,std::memory_order_relaxed);
+    }
+
+  static uint64_t get(const std::atomic<uint64_t>& counter) {
+    return counter.load(std::memory_order_relaxed);
+    }
+
+  static void count(FileStats::Counters& c, uint64_t bytes, uint64_t openNs, uint64_t readNs, bool mapped) {
+    add(c.reads,1);
+    add(c.bytes,bytes);
+    add(c.openNs,openNs);
+    add(c.readNs,readNs);
+    if(mapped)
+      add(c.mapped,1);
+    }
+
+  static void reset(FileStats::Counters& c) {
+    c.reads  = 0;
+    c.bytes  = 0;
+    c.mapped = 0;
+    c.hits   = 0;
+    c.openNs = 0;
+    c.readNs = 0;
+    }
+
+  static void writeJsonString(std::ostream& out, std::string_view str) {
+    static const char hex[] = "0123456789abcdef";
+    out << '"';
+    for(char c:str) {
+      const uint8_t b = uint8_t(c);
+      if(b<0x20) {
+        out << "\\u00" << hex[b>>4] << hex[b&0xF];
+        continue;
+        }
+      if(c=='"' || c=='\\')
+        out << '\\';
+      out << c;
+      }
+    out << '"';
+    }
+
+  static void writeCsvString(std::ostream& out, std::string_view str) {
+    out << '"';
+    for(char c:str) {
+      if(c=='"')
+        out << '"';
+      out << c;
+      }
+    out << '"';
+    }
+
+  static void writeJsonCounters(std::ostream& out, const FileStats::Counters& c) {
+    out << "\"reads\":"   << get(c.reads)
+        << ",\"bytes\":"  << get(c.bytes)
+        << ",\"mapped\":" << get(c.mapped)
+        << ",\"hits\":"   << get(c.hits)
+        << ",\"openNs\":" << get(c.openNs)
+        << ",\"readNs\":" << get(c.readNs);
+    }
+
+  static void writeJsonHistogram(std::ostream& out, const FileStats::Histogram& h) {
+    out << '[';
+    for(size_t i=0; i<FileStats::Histogram::NUM_BUCKETS; ++i)
+      out << (i==0 ? "" : ",") << get(h.buckets[i]);
+    out << ']';
+    }
+
+  static void writeCsvCounters(std::ostream& out, const FileStats::Counters& c) {
+    out << ',' << get(c.reads) << ',' << get(c.bytes) << ',' << get(c.mapped) << ',' << get(c.hits)
+        << ',' << get(c.openNs) << ',' << get(c.readNs) << '\n';
+    }
+}  // namespace internal
+
+void FileStats::Histogram::add(uint64_t ns) {
+  uint64_t us     = ns/1000;
+  size_t   bucket = 0;
+  while(us>=2 && bucket+1<NUM_BUCKETS) {
+    us >>= 1;
+    ++bucket;
+    }
+  internal::add(buckets[bucket],1);
+  }
+
+FileStats::FileStats(size_t numFiles, size_t numArchives)
+  :m_Files(numFiles), m_Archives(numArchives+1) {
+  }
+
+uint64_t FileStats::now() {
+  auto t = std::chrono::steady_clock::now().time_since_epoch();
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(t).count());
+  }
+
+void FileStats::record(size_t file, size_t archive, uint64_t bytes, uint64_t start, uint64_t opened, bool mapped) {
+  const uint64_t end    = now();
+  const uint64_t openNs = opened-start;
+  const uint64_t readNs = end-opened;
+
+  internal::count(m_Files[file],bytes,openNs,readNs,mapped);
+
+  ArchiveCounters& a = m_Archives[archive];
+  internal::count(a,bytes,openNs,readNs,mapped);
+  a.openLatency.add(openNs);
+  a.readLatency.add(readNs);
+  }
+
+void FileStats::recordUnindexed(uint64_t bytes, uint64_t start, uint64_t opened, bool mapped) {
+  const uint64_t end    = now();
+  const uint64_t openNs = opened-start;
+  const uint64_t readNs = end-opened;
+
+  ArchiveCounters& a = m_Archives.back();
+  internal::count(a,bytes,openNs,readNs,mapped);
+  a.openLatency.add(openNs);
+  a.readLatency.add(readNs);
+  }
+
+void FileStats::recordHit(size_t file, size_t archive) {
+  internal::add(m_Files[file].hits,1);
+  internal::add(m_Archives[archive].hits,1);
+  }
+
+void FileStats::reset() {
+  for(auto& f:m_Files)
+    internal::reset(f);
+  for(auto& a:m_Archives) {
+    internal::reset(a);
+    for(auto& b:a.openLatency.buckets)
+      b = 0;
+    for(auto& b:a.readLatency.buckets)
+      b = 0;
+    }
+  m_Misses = 0;
+  }
+
+void FileStats::writeJson(std::ostream& out, const std::vector<std::string_view>& files,
+                          const std::vector<uint32_t>& fileArchive, const std::vector<std::string_view>& archives) const {
+  out << "{\"misses\":" << misses() << ",\"archives\":[";
+  for(size_t i=0; i<m_Archives.size(); ++i) {
+    const ArchiveCounters& a = m_Archives[i];
+    out << (i==0 ? "" : ",") << "{\"path\":";
+    if(i<archives.size())
+      internal::writeJsonString(out,archives[i]);
+    else
+      out << "null";
+    out << ',';
+    internal::writeJsonCounters(out,a);
+    out << ",\"openLatency\":";
+    internal::writeJsonHistogram(out,a.openLatency);
+    out << ",\"readLatency\":";
+    internal::writeJsonHistogram(out,a.readLatency);
+    out << '}';
+    }
+
+  out << "],\"files\":[";
+  bool first = true;
+  for(size_t i=0; i<m_Files.size(); ++i) {
+    const Counters& f = m_Files[i];
+    if(internal::get(f.reads)==0 && internal::get(f.hits)==0)
+      continue;
+    out << (first ? "" : ",") << "{\"name\":";
+    internal::writeJsonString(out,files[i]);
+    out << ",\"archive\":" << fileArchive[i] << ',';
+    internal::writeJsonCounters(out,f);
+    out << '}';
+    first = false;
+    }
+  out << "]}\n";
+  }
+
+void FileStats::writeCsv(std::ostream& out, const std::vector<std::string_view>& files,
+                         const std::vector<uint32_t>& fileArchive, const std::vector<std::string_view>& archives) const {
+  out << "kind,name,archive,reads,bytes,mapped,hits,open_ns,read_ns\n";
+  for(size_t i=0; i<m_Archives.size(); ++i) {
+    out << "archive,";
+    internal::writeCsvString(out,i<archives.size() ? archives[i] : std::string_view());
+    out << ',' << i;
+    internal::writeCsvCounters(out,m_Archives[i]);
+    }
+  for(size_t i=0; i<m_Files.size(); ++i) {
+    if(internal::get(m_Files[i].reads)==0 && internal::get(m_Files[i].hits)==0)
+      continue;
+    out << "file,";
+    internal::writeCsvString(out,files[i]);
+    out << ',' << fileArchive[i];
+    internal::writeCsvCounters(out,m_Files[i]);
+    }
+  }
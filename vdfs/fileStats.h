@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace VDFS
+{
+    /**
+      * @brief Read-counters of the file-index. Only uses relaxed atomics, so it's cheap enough to be left on.
+      */
+    class FileStats
+    {
+    public:
+      /**
+        * @brief Latency histogram. Bucket 0 counts everything below 2us, bucket i the range [2^i, 2^(i+1)) us,
+        *        the last one everything above.
+        */
+      struct Histogram
+      {
+        static const size_t NUM_BUCKETS = 20;
+
+        std::atomic<uint64_t> buckets[NUM_BUCKETS] = {};
+
+        void add(uint64_t ns);
+      };
+
+      struct Counters
+      {
+        std::atomic<uint64_t> reads{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> mapped{0};  // Reads served straight from a mapping, without copying
+        std::atomic<uint64_t> hits{0};    // Requests answered from a cache of the index without reading the file
+        std::atomic<uint64_t> openNs{0};  // Time spent looking the file up and opening it
+        std::atomic<uint64_t> readNs{0};  // Time spent reading or mapping the data
+      };
+
+      struct ArchiveCounters : Counters
+      {
+        Histogram openLatency;
+        Histogram readLatency;
+      };
+
+      /**
+        * @param numFiles    number of files in the index
+        * @param numArchives number of mounted archives. An extra slot collects reads served by PhysFS alone.
+        */
+      FileStats(size_t numFiles, size_t numArchives);
+      FileStats(FileStats&)=delete;
+      FileStats(FileStats&&)=delete;
+      FileStats& operator=(FileStats&)=delete;
+      FileStats& operator=(FileStats&&)=delete;
+
+      /**
+        * @return current time in nanoseconds, for the arguments of record()
+        */
+      static uint64_t now();
+
+      /**
+        * @brief Counts a read of the given index-entry
+        * @param start  time the request came in
+        * @param opened time the file was found
+        */
+      void record(size_t file, size_t archive, uint64_t bytes, uint64_t start, uint64_t opened, bool mapped);
+
+      /**
+        * @brief Counts a read of a file not in the index
+        */
+      void recordUnindexed(uint64_t bytes, uint64_t start, uint64_t opened, bool mapped);
+
+      /**
+        * @brief Counts a request for the given index-entry answered from a cache, see FileIndex::getContentHash()
+        */
+      void recordHit(size_t file, size_t archive);
+
+      /**
+        * @brief Counts a request for a file which doesn't exist
+        */
+      void recordMiss() { m_Misses.fetch_add(1,std::memory_order_relaxed); }
+
+      const Counters&        file(size_t i)    const { return m_Files[i]; }
+      const ArchiveCounters& archive(size_t i) const { return m_Archives[i]; }
+      const ArchiveCounters& unindexed()       const { return m_Archives.back(); }
+      uint64_t               misses()          const { return m_Misses.load(std::memory_order_relaxed); }
+
+      /**
+        * @brief Sets all counters back to zero. Reads running meanwhile may or may not be counted.
+        */
+      void reset();
+
+      /**
+        * @brief Writes all counters. Files which were never requested are left out.
+        * @param files       name of each file-slot
+        * @param fileArchive archive-slot each file belongs to
+        * @param archives    path of each archive-slot, except the one for PhysFS
+        */
+      void writeJson(std::ostream& out, const std::vector<std::string_view>& files,
+                     const std::vector<uint32_t>& fileArchive, const std::vector<std::string_view>& archives) const;
+      void writeCsv(std::ostream& out, const std::vector<std::string_view>& files,
+                    const std::vector<uint32_t>& fileArchive, const std::vector<std::string_view>& archives) const;
+
+    private:
+      std::vector<Counters>        m_Files;
+      std::vector<ArchiveCounters> m_Archives;
+      std::atomic<uint64_t>        m_Misses{0};
+    };
+}  // namespace VDFS
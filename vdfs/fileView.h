@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mappedFile.h"
+
+namespace VDFS
+{
+    /**
+      * @brief Read-only view onto the contents of a file inside the file-index.
+      *        The view keeps whatever backs the bytes alive (a memory-mapped archive
+      *        or an owned buffer), so it can be copied around and outlive the index.
+      */
+    class FileView
+    {
+    public:
+      FileView() = default;
+
+      /**
+        * @param owner Object which keeps the memory behind data alive
+        */
+      FileView(std::shared_ptr<const void> owner, const uint8_t* data, size_t size, bool mapped)
+        : m_Owner(std::move(owner)), m_Data(data), m_Size(size), m_Mapped(mapped)
+      {
+      }
+
+      /**
+        * @brief Creates a view owning the given buffer
+        */
+      explicit FileView(std::vector<uint8_t>&& data)
+      {
+        auto buf = std::make_shared<std::vector<uint8_t>>(std::move(data));
+        m_Data   = buf->data();
+        m_Size   = buf->size();
+        m_Owner  = std::move(buf);
+      }
+
+      const uint8_t* data()  const { return m_Data; }
+      size_t         size()  const { return m_Size; }
+      bool           empty() const { return m_Size==0; }
+
+      const uint8_t* begin() const { return m_Data; }
+      const uint8_t* end()   const { return m_Data+m_Size; }
+
+      /**
+        * @return Whether the bytes are mapped straight from disk instead of being copied into an owned buffer
+        */
+      bool           isMapped() const { return m_Mapped; }
+
+      /**
+        * @brief Hints that the view will be read front to back. No-op for owned buffers.
+        */
+      void adviseSequential() const
+      {
+        if(m_Mapped)
+          MappedFile::adviseSequential(m_Data, m_Size);
+      }
+
+      /**
+        * @brief Drops the given range from memory, it is read from disk again if touched later. No-op for owned buffers.
+        */
+      void release(size_t offset, size_t size) const
+      {
+        if(!m_Mapped || offset>=m_Size)
+          return;
+        MappedFile::release(m_Data+offset, size<m_Size-offset ? size : m_Size-offset);
+      }
+
+    private:
+      std::shared_ptr<const void> m_Owner;
+      const uint8_t*              m_Data   = nullptr;
+      size_t                      m_Size   = 0;
+      bool                        m_Mapped = false;
+    };
+}  // namespace VDFS
@@ -0,0 +1,192 @@
+#include "indexCache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "archive.h"
+#include "mappedFile.h"
+#include "utils/logger.h"
+
+using namespace VDFS;
+
+namespace internal
+{
+  static const char     CACHE_MAGIC[8] = {'Z','L','V','D','F','I','D','X'};
+  static const uint32_t CACHE_VERSION  = 1;
+
+  // Every table is an array of these, so the file can be used straight from the mapping
+#pragma pack(push, 1)
+  struct CacheHeader
+  {
+    char     magic[8];
+    uint32_t version;
+    uint32_t numArchives;
+    uint32_t numEntries;
+    uint32_t stringsSize;
+  };
+
+  struct CacheArchive
+  {
+    uint64_t fileSize;
+    uint32_t timestamp;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    uint32_t firstEntry;
+    uint32_t numEntries;
+    uint32_t reserved;
+  };
+
+  struct CacheEntry
+  {
+    uint32_t offset;
+    uint32_t size;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+  };
+#pragma pack(pop)
+
+  static const CacheArchive* archives(const uint8_t* data) {
+    return reinterpret_cast<const CacheArchive*>(data + sizeof(CacheHeader));
+    }
+}  // namespace internal
+
+IndexCache::IndexCache(const std::string& path)
+  :m_Path(path) {
+  load();
+  }
+
+IndexCache::~IndexCache() {
+  }
+
+void IndexCache::load() {
+  m_Map.reset();
+  m_ArchiveByPath.clear();
+
+  auto map = MappedFile::open(m_Path);
+  if(map==nullptr || map->size()<sizeof(internal::CacheHeader)) {
+    m_Stale = true;
+    return;
+    }
+
+  internal::CacheHeader header = {};
+  std::memcpy(&header, map->data(), sizeof(header));
+  const uint64_t expectedSize = sizeof(internal::CacheHeader)
+                              + uint64_t(header.numArchives)*sizeof(internal::CacheArchive)
+                              + uint64_t(header.numEntries)*sizeof(internal::CacheEntry)
+                              + header.stringsSize;
+  if(std::memcmp(header.magic, internal::CACHE_MAGIC, sizeof(header.magic))!=0 ||
+     header.version!=internal::CACHE_VERSION || expectedSize!=map->size()) {
+    LogInfo() << "Ignoring outdated VDF-Index cache " << m_Path;
+    m_Stale = true;
+    return;
+    }
+
+  const uint8_t* strings = map->data() + expectedSize - header.stringsSize;
+  auto           arch    = internal::archives(map->data());
+  for(uint32_t i=0; i<header.numArchives; ++i) {
+    internal::CacheArchive a = {};
+    std::memcpy(&a, &arch[i], sizeof(a));
+    if(uint64_t(a.pathOffset)+a.pathLength>header.stringsSize ||
+       uint64_t(a.firstEntry)+a.numEntries>header.numEntries) {
+      m_Stale = true;
+      return;
+      }
+    m_ArchiveByPath.emplace(std::string(reinterpret_cast<const char*>(strings)+a.pathOffset,a.pathLength), i);
+    }
+  m_Map = std::move(map);
+  }
+
+std::unique_ptr<Archive> IndexCache::open(const std::string& vdf, const std::string& mountPoint) {
+  auto it = m_ArchiveByPath.find(vdf);
+  if(m_Map==nullptr || it==m_ArchiveByPath.end())
+    return nullptr;
+
+  internal::CacheHeader header = {};
+  std::memcpy(&header, m_Map->data(), sizeof(header));
+
+  internal::CacheArchive a = {};
+  std::memcpy(&a, &internal::archives(m_Map->data())[it->second], sizeof(a));
+
+  auto entries = reinterpret_cast<const internal::CacheEntry*>(internal::archives(m_Map->data()) + header.numArchives);
+  auto strings = reinterpret_cast<const char*>(m_Map->data()) + m_Map->size() - header.stringsSize;
+
+  std::vector<Archive::Entry> list(a.numEntries);
+  for(uint32_t i=0; i<a.numEntries; ++i) {
+    internal::CacheEntry e = {};
+    std::memcpy(&e, &entries[a.firstEntry+i], sizeof(e));
+    if(uint64_t(e.nameOffset)+e.nameLength>header.stringsSize)
+      return nullptr;
+    list[i].name.assign(strings+e.nameOffset, e.nameLength);
+    list[i].offset = e.offset;
+    list[i].size   = e.size;
+    }
+
+  return Archive::openVdfCached(vdf,mountPoint,a.fileSize,a.timestamp,std::move(list));
+  }
+
+bool IndexCache::write(const std::vector<std::unique_ptr<Archive>>& archives) {
+  std::vector<internal::CacheArchive> arch;
+  std::vector<internal::CacheEntry>   entries;
+  std::string                         strings;
+
+  for(auto& a:archives) {
+    if(a->type()!=Archive::T_Vdf)
+      continue;
+
+    internal::CacheArchive ca = {};
+    ca.fileSize   = a->fileSize();
+    ca.timestamp  = a->timestamp();
+    ca.pathOffset = uint32_t(strings.size());
+    ca.pathLength = uint32_t(a->path().size());
+    ca.firstEntry = uint32_t(entries.size());
+    ca.numEntries = uint32_t(a->entries().size());
+    strings += a->path();
+
+    for(auto& e:a->entries()) {
+      internal::CacheEntry ce = {};
+      ce.offset     = uint32_t(e.offset);
+      ce.size       = uint32_t(e.size);
+      ce.nameOffset = uint32_t(strings.size());
+      ce.nameLength = uint32_t(e.name.size());
+      strings += e.name;
+      entries.push_back(ce);
+      }
+    arch.push_back(ca);
+    }
+
+  internal::CacheHeader header = {};
+  std::memcpy(header.magic, internal::CACHE_MAGIC, sizeof(header.magic));
+  header.version     = internal::CACHE_VERSION;
+  header.numArchives = uint32_t(arch.size());
+  header.numEntries  = uint32_t(entries.size());
+  header.stringsSize = uint32_t(strings.size());
+
+  // Write to a temporary first, so a crash can't leave a broken cache behind.
+  // The old mapping has to go before replacing the file, Windows won't allow it otherwise.
+  const std::string tmp = m_Path + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(arch.data()), std::streamsize(arch.size()*sizeof(arch[0])));
+    out.write(reinterpret_cast<const char*>(entries.data()), std::streamsize(entries.size()*sizeof(entries[0])));
+    out.write(strings.data(), std::streamsize(strings.size()));
+    if(!out.good()) {
+      LogWarn() << "Failed to write VDF-Index cache " << tmp;
+      return false;
+      }
+  }
+
+  m_Map.reset();
+  std::error_code ec;
+  std::filesystem::rename(std::filesystem::u8path(tmp), std::filesystem::u8path(m_Path), ec);
+  if(ec) {
+    LogWarn() << "Failed to replace VDF-Index cache " << m_Path << ": " << ec.message();
+    std::filesystem::remove(std::filesystem::u8path(tmp), ec);
+    load();
+    return false;
+    }
+
+  m_Stale = false;
+  load();
+  return true;
+  }
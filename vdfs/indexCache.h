@@ -0,0 +1,54 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace VDFS
+{
+    class Archive;
+    class MappedFile;
+
+    /**
+      * @brief On-disk cache of the directory tables of VDF-Archives, keyed by path, size and the
+      *        timestamp inside the VDF-Header. Lets archives be loaded without reading their tables.
+      */
+    class IndexCache
+    {
+    public:
+      /**
+        * @param path cache-file to use. It's fine if it doesn't exist yet.
+        */
+      explicit IndexCache(const std::string& path);
+      IndexCache(IndexCache&)=delete;
+      IndexCache(IndexCache&&)=delete;
+      ~IndexCache();
+      IndexCache& operator=(IndexCache&)=delete;
+      IndexCache& operator=(IndexCache&&)=delete;
+
+      /**
+        * @brief Opens the given VDF with the cached directory table
+        * @return nullptr if the archive isn't cached or has changed since
+        */
+      std::unique_ptr<Archive> open(const std::string& vdf, const std::string& mountPoint);
+
+      /**
+        * @brief Remembers that the cache-file is missing the given archive
+        */
+      void markStale() { m_Stale = true; }
+      bool isStale() const { return m_Stale; }
+
+      /**
+        * @brief Replaces the cache-file with the directory tables of all VDFs in the list
+        */
+      bool write(const std::vector<std::unique_ptr<Archive>>& archives);
+
+    private:
+      void load();
+
+      std::string                             m_Path;
+      std::shared_ptr<MappedFile>             m_Map;
+      std::unordered_map<std::string, size_t> m_ArchiveByPath;
+      bool                                    m_Stale = false;
+    };
+}  // namespace VDFS
@@ -0,0 +1,45 @@
+#include "ioPool.h"
+
+using namespace VDFS;
+
+IoPool::IoPool(size_t numThreads) {
+  if(numThreads==0)
+    numThreads = 1;
+  m_Threads.reserve(numThreads);
+  for(size_t i=0; i<numThreads; ++i)
+    m_Threads.emplace_back(&IoPool::workerLoop,this);
+  }
+
+IoPool::~IoPool() {
+  {
+    std::lock_guard<std::mutex> guard(m_Sync);
+    m_Stop = true;
+  }
+  m_Cv.notify_all();
+  for(auto& t:m_Threads)
+    t.join();
+  }
+
+void IoPool::push(std::vector<std::function<void()>>&& jobs) {
+  {
+    std::lock_guard<std::mutex> guard(m_Sync);
+    for(auto& j:jobs)
+      m_Jobs.emplace_back(std::move(j));
+  }
+  m_Cv.notify_all();
+  }
+
+void IoPool::workerLoop() {
+  while(true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> guard(m_Sync);
+      m_Cv.wait(guard,[this](){ return m_Stop || !m_Jobs.empty(); });
+      if(m_Jobs.empty())
+        return;
+      job = std::move(m_Jobs.front());
+      m_Jobs.pop_front();
+    }
+    job();
+    }
+  }
@@ -0,0 +1,41 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VDFS
+{
+    /**
+      * @brief Small pool of threads working off a FIFO of IO-jobs
+      */
+    class IoPool
+    {
+    public:
+      explicit IoPool(size_t numThreads);
+      IoPool(IoPool&)=delete;
+      IoPool(IoPool&&)=delete;
+      /**
+        * @brief Finishes all queued jobs, then stops the threads
+        */
+      ~IoPool();
+      IoPool& operator=(IoPool&)=delete;
+      IoPool& operator=(IoPool&&)=delete;
+
+      /**
+        * @brief Queues the given jobs. They are started in the order given.
+        */
+      void push(std::vector<std::function<void()>>&& jobs);
+
+    private:
+      void workerLoop();
+
+      std::mutex                        m_Sync;
+      std::condition_variable           m_Cv;
+      std::deque<std::function<void()>> m_Jobs;
+      std::vector<std::thread>          m_Threads;
+      bool                              m_Stop = false;
+    };
+}  // namespace VDFS
@@ -0,0 +1,210 @@
+#include "mappedFile.h"
+#include <cerrno>
+#include <cstring>
+
+#if defined(WIN32) || defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace VDFS;
+
+// Read one byte of every page, the volatile store keeps the loads alive
+static volatile uint8_t pageSink = 0;
+
+static void touchPages(const uint8_t* data, size_t size, size_t page) {
+  uint8_t acc = 0;
+  for(size_t i=0; i<size; i+=page)
+    acc ^= data[i];
+  if(size>0)
+    acc ^= data[size-1];
+  pageSink = acc;
+  }
+
+bool MappedFile::copy(uint64_t offset, void* dest, size_t size) const {
+  if(offset>m_Size || size>m_Size-offset)
+    return false;
+  if(size>0)
+    std::memcpy(dest, m_Data+offset, size);
+  return true;
+  }
+
+#if defined(WIN32) || defined(_WIN32)
+static std::wstring toWide(const std::string& str) {
+  int len = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), int(str.size()), nullptr, 0);
+  std::wstring ret(size_t(len), L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, str.c_str(), int(str.size()), &ret[0], len);
+  return ret;
+  }
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& path, bool positionalReads) {
+  HANDLE file = CreateFileW(toWide(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(file==INVALID_HANDLE_VALUE)
+    return nullptr;
+
+  LARGE_INTEGER size = {};
+  if(!GetFileSizeEx(file,&size) || uint64_t(size.QuadPart)>uint64_t(SIZE_MAX)) {
+    CloseHandle(file);
+    return nullptr;
+    }
+
+  std::shared_ptr<MappedFile> ret(new MappedFile());
+  ret->m_File = file;
+  ret->m_Size = size_t(size.QuadPart);
+  if(ret->m_Size==0) {
+    if(!positionalReads) {
+      CloseHandle(ret->m_File);
+      ret->m_File = nullptr;
+      }
+    return ret;
+    }
+
+  ret->m_Mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if(ret->m_Mapping==nullptr)
+    return nullptr;
+
+  ret->m_Data = reinterpret_cast<const uint8_t*>(MapViewOfFile(ret->m_Mapping, FILE_MAP_READ, 0, 0, 0));
+  if(ret->m_Data==nullptr)
+    return nullptr;
+
+  // The view keeps the mapping alive on its own
+  CloseHandle(ret->m_Mapping);
+  ret->m_Mapping = nullptr;
+  if(!positionalReads) {
+    CloseHandle(ret->m_File);
+    ret->m_File = nullptr;
+    }
+  return ret;
+  }
+
+bool MappedFile::read(uint64_t offset, void* dest, size_t size) const {
+  if(m_File==nullptr)
+    return copy(offset, dest, size);
+  auto out = reinterpret_cast<uint8_t*>(dest);
+  while(size>0) {
+    // Handles aren't opened for overlapped IO, so this is still a blocking read from the given offset
+    OVERLAPPED ov = {};
+    ov.Offset     = DWORD(offset);
+    ov.OffsetHigh = DWORD(offset>>32);
+
+    DWORD chunk = size>0x40000000 ? DWORD(0x40000000) : DWORD(size);
+    DWORD done  = 0;
+    if(!ReadFile(m_File, out, chunk, &done, &ov) || done==0)
+      return false;
+    out    += done;
+    offset += done;
+    size   -= done;
+    }
+  return true;
+  }
+
+void MappedFile::willNeed(const uint8_t* data, size_t size) {
+  SYSTEM_INFO info = {};
+  GetSystemInfo(&info);
+  touchPages(data,size,size_t(info.dwPageSize));
+  }
+
+void MappedFile::adviseSequential(const uint8_t*, size_t) {
+  // Windows has no equivalent for views, read-ahead works fine on its own
+  }
+
+void MappedFile::release(const uint8_t* data, size_t size) {
+  // Unlocking pages which aren't locked removes them from the working set
+  if(size>0)
+    VirtualUnlock(const_cast<uint8_t*>(data), size);
+  }
+
+MappedFile::~MappedFile() {
+  if(m_Data!=nullptr)
+    UnmapViewOfFile(m_Data);
+  if(m_Mapping!=nullptr)
+    CloseHandle(m_Mapping);
+  if(m_File!=nullptr)
+    CloseHandle(m_File);
+  }
+#else
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& path, bool positionalReads) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if(fd<0)
+    return nullptr;
+
+  struct stat st = {};
+  if(fstat(fd,&st)!=0 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    return nullptr;
+    }
+
+  std::shared_ptr<MappedFile> ret(new MappedFile());
+  ret->m_Fd   = fd;
+  ret->m_Size = size_t(st.st_size);
+  if(ret->m_Size>0) {
+    void* ptr = mmap(nullptr, ret->m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(ptr==MAP_FAILED)
+      return nullptr;
+    ret->m_Data = reinterpret_cast<const uint8_t*>(ptr);
+    }
+
+  // The mapping stays valid without the descriptor, it's only kept for positional reads
+  if(!positionalReads) {
+    ::close(ret->m_Fd);
+    ret->m_Fd = -1;
+    }
+  return ret;
+  }
+
+bool MappedFile::read(uint64_t offset, void* dest, size_t size) const {
+  if(m_Fd<0)
+    return copy(offset, dest, size);
+  auto out = reinterpret_cast<uint8_t*>(dest);
+  while(size>0) {
+    ssize_t done = ::pread(m_Fd, out, size, off_t(offset));
+    if(done<0 && errno==EINTR)
+      continue;
+    if(done<=0)
+      return false;
+    out    += done;
+    offset += uint64_t(done);
+    size   -= size_t(done);
+    }
+  return true;
+  }
+
+void MappedFile::willNeed(const uint8_t* data, size_t size) {
+  const size_t page  = size_t(sysconf(_SC_PAGESIZE));
+  const auto   begin = uintptr_t(data) & ~uintptr_t(page-1);
+  if(size>0)
+    madvise(reinterpret_cast<void*>(begin), uintptr_t(data)+size-begin, MADV_WILLNEED);
+  touchPages(data,size,page);
+  }
+
+void MappedFile::adviseSequential(const uint8_t* data, size_t size) {
+  if(size==0)
+    return;
+  const size_t page  = size_t(sysconf(_SC_PAGESIZE));
+  const auto   begin = uintptr_t(data) & ~uintptr_t(page-1);
+  madvise(reinterpret_cast<void*>(begin), uintptr_t(data)+size-begin, MADV_SEQUENTIAL);
+  }
+
+void MappedFile::release(const uint8_t* data, size_t size) {
+  // Only whole pages, the neighbours might still be in use
+  const size_t page  = size_t(sysconf(_SC_PAGESIZE));
+  const auto   begin = (uintptr_t(data)+page-1) & ~uintptr_t(page-1);
+  const auto   end   = (uintptr_t(data)+size) & ~uintptr_t(page-1);
+  if(end>begin)
+    madvise(reinterpret_cast<void*>(begin), end-begin, MADV_DONTNEED);
+  }
+
+MappedFile::~MappedFile() {
+  if(m_Data!=nullptr)
+    munmap(const_cast<uint8_t*>(m_Data), m_Size);
+  if(m_Fd>=0)
+    ::close(m_Fd);
+  }
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace VDFS
+{
+    /**
+      * @brief Read-only memory mapping of a whole file on disk
+      */
+    class MappedFile
+    {
+    public:
+      MappedFile(MappedFile&)=delete;
+      MappedFile(MappedFile&&)=delete;
+      ~MappedFile();
+      MappedFile& operator=(MappedFile&)=delete;
+      MappedFile& operator=(MappedFile&&)=delete;
+
+      /**
+        * @brief Maps the given file into memory. The file itself is closed again right away, unless
+        *        positionalReads is set, so many mappings don't use up the descriptors of the process.
+        * @param path utf8-encoded path to the file
+        * @param positionalReads keep the file open, so read() goes to the file instead of the mapping
+        * @return nullptr if the file could not be opened or mapped
+        */
+      static std::shared_ptr<MappedFile> open(const std::string& path, bool positionalReads = false);
+
+      const uint8_t* data() const { return m_Data; }
+      size_t         size() const { return m_Size; }
+
+      /**
+        * @brief Positional read straight from the file, bypassing the mapping, if it was opened with
+        *        positionalReads. Copies from the mapping otherwise.
+        *        Doesn't move any shared cursor, so it may be called from several threads at once.
+        * @return false if not all bytes could be read
+        */
+      bool           read(uint64_t offset, void* dest, size_t size) const;
+
+      /**
+        * @brief Faults in all pages of the given mapped range, so later accesses don't stall on disk
+        */
+      static void    willNeed(const uint8_t* data, size_t size);
+
+      /**
+        * @brief Tells the OS the given mapped range will be read front to back, so it can read ahead
+        */
+      static void    adviseSequential(const uint8_t* data, size_t size);
+
+      /**
+        * @brief Drops all pages fully inside the given mapped range from memory.
+        *        They are read again from disk when touched later.
+        */
+      static void    release(const uint8_t* data, size_t size);
+
+    private:
+      MappedFile() = default;
+
+      bool           copy(uint64_t offset, void* dest, size_t size) const;
+
+      const uint8_t* m_Data = nullptr;
+      size_t         m_Size = 0;
+#if defined(WIN32) || defined(_WIN32)
+      void*          m_File    = nullptr;
+      void*          m_Mapping = nullptr;
+#else
+      int            m_Fd      = -1;
+#endif
+    };
+}  // namespace VDFS
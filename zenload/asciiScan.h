@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ZENLOAD_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+#define ZENLOAD_SCAN_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ZenLoad
+{
+/**
+  * @brief Scanning of ASCII-Archives, 32 (AVX2) or 16 (SSE2) bytes per step depending on what the
+  *        compiler targets, byte by byte otherwise. Only ever reads inside the given range.
+  */
+namespace AsciiScan
+  {
+  inline uint32_t firstBit(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long idx = 0;
+    _BitScanForward(&idx,mask);
+    return uint32_t(idx);
+#else
+    return uint32_t(__builtin_ctz(mask));
+#endif
+    }
+
+  template<char... Cs>
+  inline bool isAny(uint8_t c) {
+    return ((c==uint8_t(Cs)) || ...);
+    }
+
+#if defined(ZENLOAD_SCAN_AVX2)
+  static const size_t STEP = 32;
+
+  template<char... Cs>
+  inline uint32_t matchMask(const uint8_t* p) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i       m = _mm256_setzero_si256();
+    ((m = _mm256_or_si256(m,_mm256_cmpeq_epi8(v,_mm256_set1_epi8(Cs)))), ...);
+    return uint32_t(_mm256_movemask_epi8(m));
+    }
+#elif defined(ZENLOAD_SCAN_SSE2)
+  static const size_t STEP = 16;
+
+  template<char... Cs>
+  inline uint32_t matchMask(const uint8_t* p) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i       m = _mm_setzero_si128();
+    ((m = _mm_or_si128(m,_mm_cmpeq_epi8(v,_mm_set1_epi8(Cs)))), ...);
+    return uint32_t(_mm_movemask_epi8(m));
+    }
+#endif
+
+  /**
+    * @return Index of the first byte which is one of Cs, size if there is none
+    */
+  template<char... Cs>
+  inline size_t findAny(const uint8_t* data, size_t size) {
+    size_t i = 0;
+#if defined(ZENLOAD_SCAN_AVX2) || defined(ZENLOAD_SCAN_SSE2)
+    for(; i+STEP<=size; i+=STEP) {
+      const uint32_t mask = matchMask<Cs...>(data+i);
+      if(mask!=0)
+        return i+firstBit(mask);
+      }
+#endif
+    for(; i<size; ++i)
+      if(isAny<Cs...>(data[i]))
+        return i;
+    return size;
+    }
+
+  /**
+    * @return Index of the first byte which is none of Cs, size if there is none
+    */
+  template<char... Cs>
+  inline size_t skipAny(const uint8_t* data, size_t size) {
+    size_t i = 0;
+#if defined(ZENLOAD_SCAN_AVX2) || defined(ZENLOAD_SCAN_SSE2)
+    const uint32_t all = uint32_t((uint64_t(1)<<STEP)-1);
+    for(; i+STEP<=size; i+=STEP) {
+      const uint32_t mask = ~matchMask<Cs...>(data+i) & all;
+      if(mask!=0)
+        return i+firstBit(mask);
+      }
+#endif
+    for(; i<size; ++i)
+      if(!isAny<Cs...>(data[i]))
+        return i;
+    return size;
+    }
+
+  /**
+    * @brief End of a line: \\r, \\t, \\n or \\0
+    */
+  inline size_t findLineEnd(const uint8_t* data, size_t size) {
+    return findAny<'\r','\t','\n','\0'>(data,size);
+    }
+
+  /**
+    * @brief End of a word: like findLineEnd(), but also stops at spaces
+    */
+  inline size_t findWordEnd(const uint8_t* data, size_t size) {
+    return findAny<'\r','\t','\n','\0',' '>(data,size);
+    }
+
+  /**
+    * @brief First character which isn't whitespace
+    */
+  inline size_t skipWhitespace(const uint8_t* data, size_t size) {
+    return skipAny<' ','\r','\t','\n'>(data,size);
+    }
+  }  // namespace AsciiScan
+}  // namespace ZenLoad
@@ -0,0 +1,81 @@
+#pragma once
+#include <type_traits>
+
+#include "parserImpl.h"
+#include "parserImplASCII.h"
+#include "parserImplBinSafe.h"
+#include "parserImplBinary.h"
+
+namespace ZenLoad
+{
+/**
+  * @brief Same entry-reading interface as ParserImpl, but bound to one implementation at compile-time:
+  *        the implementations are final, so the calls are direct instead of virtual and can be inlined where
+  *        the implementation is visible. Readers templated on it are instantiated once per archive-format,
+  *        see withEntryReader(). EntryReader<ParserImpl> falls back to virtual calls.
+  */
+template<class Impl>
+class EntryReader {
+  public:
+    using EZenValueType = ParserImpl::EZenValueType;
+
+    explicit EntryReader(Impl& impl):m_Impl(impl){}
+
+    void readEntry(const char* name, std::string&   target, bool optional=false) { read(name, &target,              0, ParserImpl::ZVT_STRING   ,optional); }
+    void readEntry(const char* name, uint8_t&       target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_BYTE     ,optional); }
+    void readEntry(const char* name, bool&          target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_BOOL     ,optional); }
+    void readEntry(const char* name, uint16_t&      target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_WORD     ,optional); }
+    void readEntry(const char* name, int16_t&       target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_WORD     ,optional); }
+    void readEntry(const char* name, uint32_t&      target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_INT      ,optional); }
+    void readColor(const char* name, uint32_t&      target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_COLOR    ,optional); }
+    void readEntry(const char* name, int32_t&       target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_INT      ,optional); }
+    void readEntry(const char* name, float&         target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_FLOAT    ,optional); }
+    void readEntry(const char* name, ZMath::float2& target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_RAW_FLOAT,optional); }
+    void readEntry(const char* name, ZMath::float3& target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_VEC3     ,optional); }
+    void readEntry(const char* name, ZMath::float4& target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_RAW_FLOAT,optional); }
+    void readEntry(const char* name, ZMath::Matrix& target, bool optional=false) { read(name, &target, sizeof(target), ParserImpl::ZVT_RAW_FLOAT,optional); }
+    void readEntry(const char* name, Daedalus::ZString& tg, bool optional=false) { std::string s; this->readEntry(name,s,optional); tg = Daedalus::ZString(std::move(s)); }
+
+    void readEntry(const char* name, void* target, size_t size, bool optional=false) { read(name, target, size, ParserImpl::ZVT_RAW, optional); }
+
+    bool readChunkStart(ZenParser::ChunkHeader& header) { return m_Impl.readChunkStart(header); }
+    bool readChunkEnd() { return m_Impl.readChunkEnd(); }
+
+  private:
+    void read(const char* name, void* target, size_t size, EZenValueType type, bool optional) {
+      if constexpr(std::is_same<Impl,ParserImplBinSafe>::value) {
+        if(!optional && m_Impl.readValueFast(type, target, size))
+          return;
+        }
+      m_Impl.readEntryImpl(name, target, size, type, optional);
+      }
+
+    Impl& m_Impl;
+  };
+
+/**
+  * @brief Calls fn with the EntryReader matching the archive-format of the parser
+  */
+template<class Fn>
+inline void withEntryReader(ZenParser& parser, Fn&& fn) {
+  ParserImpl* impl = parser.getImpl();
+  switch(parser.getZenHeader().fileType) {
+    case ZenParser::FT_ASCII: {
+      EntryReader<ParserImplASCII> rd(static_cast<ParserImplASCII&>(*impl));
+      return fn(rd);
+      }
+    case ZenParser::FT_BINSAFE: {
+      EntryReader<ParserImplBinSafe> rd(static_cast<ParserImplBinSafe&>(*impl));
+      return fn(rd);
+      }
+    case ZenParser::FT_BINARY: {
+      EntryReader<ParserImplBinary> rd(static_cast<ParserImplBinary&>(*impl));
+      return fn(rd);
+      }
+    default: {
+      EntryReader<ParserImpl> rd(*impl);
+      return fn(rd);
+      }
+    }
+  }
+}  // namespace ZenLoad
@@ -0,0 +1,715 @@
+#include "meshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ZenLoad;
+
+namespace internal
+{
+  static const uint32_t INVALID = uint32_t(-1);
+
+  // Seeds in morton-order looked at for one that is near a cluster, before the cluster is closed
+  static const size_t   SEED_WINDOW = 64;
+
+  /**
+   * @brief Post-transform cache of a GPU, modeled as FIFO. Entries are stamped with the number of misses
+   *        so far, so resetting it doesn't need to touch the vertices.
+   */
+  class FifoCache
+  {
+  public:
+    FifoCache(size_t numVertices, size_t cacheSize)
+      :m_Stamp(numVertices, 0), m_Size(cacheSize), m_Time(cacheSize+1) {
+      }
+
+    void reset() { m_Time += m_Size+1; }
+
+    /**
+     * @return true if the vertex had to be transformed
+     */
+    bool miss(uint32_t v) {
+      if(m_Time-m_Stamp[v]<=m_Size)
+        return false;
+      m_Stamp[v] = m_Time++;
+      return true;
+      }
+
+    size_t misses(const uint32_t* indices, size_t numIndices) {
+      reset();
+      size_t num = 0;
+      for(size_t i=0; i<numIndices; ++i)
+        if(miss(indices[i]))
+          ++num;
+      return num;
+      }
+
+  private:
+    std::vector<size_t> m_Stamp;
+    size_t              m_Size;
+    size_t              m_Time;
+  };
+
+  /**
+   * @brief Triangles of a triangle-list around each of its vertices. Vertices get dense ids, so the
+   *        arrays only grow with the list, not with the whole mesh.
+   */
+  struct Adjacency
+  {
+    std::vector<uint32_t> triangleVertices;  // Dense id of each index
+    std::vector<uint32_t> start;             // Range of each vertex in triangles
+    std::vector<uint32_t> triangles;
+    size_t                numVertices = 0;
+
+    /**
+     * @param localId one entry per vertex of the mesh, all INVALID. Left that way.
+     */
+    Adjacency(const uint32_t* indices, size_t numIndices, std::vector<uint32_t>& localId)
+      :triangleVertices(numIndices), triangles(numIndices) {
+      std::vector<uint32_t> globalId;
+      for(size_t i=0; i<numIndices; ++i) {
+        uint32_t& id = localId[indices[i]];
+        if(id==INVALID) {
+          id = uint32_t(globalId.size());
+          globalId.push_back(indices[i]);
+          }
+        triangleVertices[i] = id;
+        }
+      for(auto g:globalId)
+        localId[g] = INVALID;
+      numVertices = globalId.size();
+
+      start.assign(numVertices+1, 0);
+      for(auto v:triangleVertices)
+        start[v+1]++;
+      for(size_t v=0; v<numVertices; ++v)
+        start[v+1] += start[v];
+      std::vector<uint32_t> fill(start.begin(), start.end()-1);
+      for(size_t i=0; i<numIndices; ++i)
+        triangles[fill[triangleVertices[i]]++] = uint32_t(i/3);
+      }
+  };
+
+  /**
+   * @brief Scores of Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+   */
+  class ForsythScore
+  {
+  public:
+    static const size_t CACHE_SIZE = 32;
+
+    ForsythScore() {
+      for(size_t i=0; i<CACHE_SIZE; ++i)
+        m_Cache[i] = i<3 ? 0.75f : std::pow(1.f - float(i-3)/float(CACHE_SIZE-3), 1.5f);
+      m_Valence[0] = 0;
+      for(size_t i=1; i<MAX_VALENCE; ++i)
+        m_Valence[i] = valence(i);
+      }
+
+    float vertex(int32_t cachePos, uint32_t liveTriangles) const {
+      if(liveTriangles==0)
+        return -1.f;
+      const float cache = cachePos>=0 ? m_Cache[cachePos] : 0.f;
+      return cache + (liveTriangles<MAX_VALENCE ? m_Valence[liveTriangles] : valence(liveTriangles));
+      }
+
+  private:
+    static const size_t MAX_VALENCE = 32;
+
+    static float valence(size_t liveTriangles) {
+      return 2.f*std::pow(float(liveTriangles), -0.5f);
+      }
+
+    float m_Cache[CACHE_SIZE];
+    float m_Valence[MAX_VALENCE];
+  };
+
+  /**
+   * @brief Orders the triangles of a triangle-list, so vertices are reused while they are still in the cache
+   * @param localId one entry per vertex of the mesh, all INVALID. Left that way.
+   * @param order receives the triangles of the list in their new order
+   */
+  static void optimizeVertexCache(const uint32_t* indices, size_t numIndices, std::vector<uint32_t>& localId,
+                                  std::vector<uint32_t>& order) {
+    static const ForsythScore score;
+    const size_t numTriangles = numIndices/3;
+
+    // Triangles not emitted yet of each vertex are kept in front of its range of the adjacency
+    Adjacency                    vertexTriangles(indices, numIndices, localId);
+    const std::vector<uint32_t>& tri         = vertexTriangles.triangleVertices;
+    std::vector<uint32_t>&       adjacency   = vertexTriangles.triangles;
+    const size_t                 numVertices = vertexTriangles.numVertices;
+    std::vector<uint32_t>        liveTriangles(numVertices);
+    for(size_t v=0; v<numVertices; ++v)
+      liveTriangles[v] = vertexTriangles.start[v+1]-vertexTriangles.start[v];
+
+    std::vector<int32_t> cachePos(numVertices, -1);
+    std::vector<float>   vertexScore(numVertices);
+    std::vector<float>   triangleScore(numTriangles);
+    std::vector<uint8_t> emitted(numTriangles, 0);
+    for(size_t v=0; v<numVertices; ++v)
+      vertexScore[v] = score.vertex(-1, liveTriangles[v]);
+    for(size_t t=0; t<numTriangles; ++t)
+      triangleScore[t] = vertexScore[tri[t*3]] + vertexScore[tri[t*3+1]] + vertexScore[tri[t*3+2]];
+
+    std::vector<uint32_t> cache, nextCache;
+    cache.reserve(ForsythScore::CACHE_SIZE+3);
+    nextCache.reserve(ForsythScore::CACHE_SIZE+3);
+
+    order.clear();
+    order.reserve(numTriangles);
+    size_t   cursor = 0;
+    uint32_t best   = INVALID;
+    while(order.size()<numTriangles) {
+      if(best==INVALID) {
+        // Nothing left next to the cache, continue with the first triangle not emitted yet
+        while(emitted[cursor])
+          ++cursor;
+        best = uint32_t(cursor);
+        }
+
+      const uint32_t* t = &tri[best*3];
+      emitted[best] = 1;
+      order.push_back(best);
+
+      for(size_t k=0; k<3; ++k) {
+        const uint32_t v     = t[k];
+        uint32_t*      adj   = &adjacency[vertexTriangles.start[v]];
+        uint32_t&      live  = liveTriangles[v];
+        for(uint32_t i=0; i<live; ++i) {
+          if(adj[i]==best) {
+            std::swap(adj[i], adj[live-1]);
+            break;
+            }
+          }
+        --live;
+        }
+
+      // The vertices of the triangle move to the front, the ones falling out at the back lose their position
+      nextCache.clear();
+      for(size_t k=0; k<3; ++k)
+        if(std::find(nextCache.begin(), nextCache.end(), t[k])==nextCache.end())
+          nextCache.push_back(t[k]);
+      for(auto v:cache)
+        if(v!=t[0] && v!=t[1] && v!=t[2])
+          nextCache.push_back(v);
+
+      for(size_t i=0; i<nextCache.size(); ++i) {
+        const uint32_t v = nextCache[i];
+        cachePos[v]    = i<ForsythScore::CACHE_SIZE ? int32_t(i) : -1;
+        vertexScore[v] = score.vertex(cachePos[v], liveTriangles[v]);
+        }
+
+      best = INVALID;
+      float bestScore = -1.f;
+      for(size_t i=0; i<nextCache.size(); ++i) {
+        const uint32_t  v   = nextCache[i];
+        const uint32_t* adj = &adjacency[vertexTriangles.start[v]];
+        for(uint32_t j=0; j<liveTriangles[v]; ++j) {
+          const uint32_t a = adj[j];
+          triangleScore[a] = vertexScore[tri[a*3]] + vertexScore[tri[a*3+1]] + vertexScore[tri[a*3+2]];
+          if(i<ForsythScore::CACHE_SIZE && triangleScore[a]>bestScore) {
+            best      = a;
+            bestScore = triangleScore[a];
+            }
+          }
+        }
+
+      if(nextCache.size()>ForsythScore::CACHE_SIZE)
+        nextCache.resize(ForsythScore::CACHE_SIZE);
+      cache.swap(nextCache);
+      }
+    }
+
+  /**
+   * @brief Reorders the triangles of a list into clusters facing outwards first, so they tend to cover the
+   *        ones behind them. Clusters start wherever the cache runs empty, so their order hardly costs cache-hits.
+   * @return false if the list is better left as it is
+   */
+  static bool optimizeOverdraw(const uint32_t* indices, size_t numIndices, const std::vector<WorldVertex>& vertices,
+                               FifoCache& fifo, float threshold, std::vector<uint32_t>& order) {
+    const size_t numTriangles = numIndices/3;
+
+    std::vector<uint32_t> clusterStart;
+    fifo.reset();
+    for(size_t t=0; t<numTriangles; ++t) {
+      size_t misses = 0;
+      for(size_t k=0; k<3; ++k)
+        if(fifo.miss(indices[t*3+k]))
+          ++misses;
+      if(t==0 || misses==3)
+        clusterStart.push_back(uint32_t(t));
+      }
+    if(clusterStart.size()<2)
+      return false;
+    clusterStart.push_back(uint32_t(numTriangles));
+
+    struct Cluster
+    {
+      uint32_t first    = 0;
+      uint32_t last     = 0;
+      float    centroid[3] = {};
+      float    normal[3]   = {};
+      float    area     = 0;
+      float    sortKey  = 0;
+    };
+
+    const size_t         numClusters = clusterStart.size()-1;
+    std::vector<Cluster> clusters(numClusters);
+    float                meshCentroid[3] = {};
+    float                meshArea        = 0;
+    for(size_t c=0; c<numClusters; ++c) {
+      Cluster& cl = clusters[c];
+      cl.first = clusterStart[c];
+      cl.last  = clusterStart[c+1];
+      for(uint32_t t=cl.first; t<cl.last; ++t) {
+        const float* p0 = vertices[indices[t*3+0]].Position.v;
+        const float* p1 = vertices[indices[t*3+1]].Position.v;
+        const float* p2 = vertices[indices[t*3+2]].Position.v;
+        const float  e1[3] = {p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]};
+        const float  e2[3] = {p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2]};
+        const float  n[3]  = {e1[1]*e2[2]-e1[2]*e2[1], e1[2]*e2[0]-e1[0]*e2[2], e1[0]*e2[1]-e1[1]*e2[0]};
+        const float  area  = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+        for(size_t k=0; k<3; ++k) {
+          cl.centroid[k] += (p0[k]+p1[k]+p2[k])/3.f * area;
+          cl.normal[k]   += n[k];
+          }
+        cl.area += area;
+        }
+      for(size_t k=0; k<3; ++k)
+        meshCentroid[k] += cl.centroid[k];
+      meshArea += cl.area;
+      if(cl.area>0)
+        for(size_t k=0; k<3; ++k)
+          cl.centroid[k] /= cl.area;
+      }
+    if(meshArea<=0)
+      return false;
+    for(size_t k=0; k<3; ++k)
+      meshCentroid[k] /= meshArea;
+
+    for(auto& cl:clusters) {
+      const float len = std::sqrt(cl.normal[0]*cl.normal[0] + cl.normal[1]*cl.normal[1] + cl.normal[2]*cl.normal[2]);
+      if(len<=0)
+        continue;
+      for(size_t k=0; k<3; ++k)
+        cl.sortKey += (cl.centroid[k]-meshCentroid[k]) * cl.normal[k]/len;
+      }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+      return a.sortKey>b.sortKey;
+      });
+
+    order.clear();
+    order.reserve(numTriangles);
+    std::vector<uint32_t> sorted;
+    sorted.reserve(numIndices);
+    for(auto& cl:clusters) {
+      for(uint32_t t=cl.first; t<cl.last; ++t) {
+        order.push_back(t);
+        sorted.insert(sorted.end(), indices+t*3, indices+t*3+3);
+        }
+      }
+
+    const size_t missesBefore = fifo.misses(indices, numIndices);
+    const size_t missesAfter  = fifo.misses(sorted.data(), numIndices);
+    return float(missesAfter)<=float(missesBefore)*threshold;
+    }
+
+  /**
+   * @brief Moves the triangles of the list and, if given, their lightmap-indices into the given order
+   */
+  static void reorder(uint32_t* indices, size_t numIndices, const std::vector<uint32_t>& order, int16_t* lightmaps) {
+    std::vector<uint32_t> sorted(numIndices);
+    for(size_t t=0; t<order.size(); ++t)
+      std::copy(indices+order[t]*3, indices+order[t]*3+3, sorted.begin()+t*3);
+    std::copy(sorted.begin(), sorted.end(), indices);
+
+    if(lightmaps!=nullptr) {
+      std::vector<int16_t> sortedLightmaps(order.size());
+      for(size_t t=0; t<order.size(); ++t)
+        sortedLightmaps[t] = lightmaps[order[t]];
+      std::copy(sortedLightmaps.begin(), sortedLightmaps.end(), lightmaps);
+      }
+    }
+
+  /**
+   * @return lightmap-indices of the triangles in the given range of the sub-mesh, if it has one per triangle
+   */
+  static int16_t* lightmaps(PackedMesh::SubMesh& sm, size_t firstTriangle) {
+    if(sm.triangleLightmapIndices.size()!=sm.indexSize/3)
+      return nullptr;
+    return sm.triangleLightmapIndices.data()+firstTriangle;
+    }
+
+  /**
+   * @brief Renumbers the vertices in the order the index-buffer uses them first. Unused ones go to the end.
+   */
+  static void optimizeVertexFetch(PackedMesh& mesh) {
+    const size_t          numVertices = mesh.vertices.size();
+    std::vector<uint32_t> remap(numVertices, INVALID);
+    uint32_t              next = 0;
+    for(auto& i:mesh.indices) {
+      if(remap[i]==INVALID)
+        remap[i] = next++;
+      i = remap[i];
+      }
+    for(auto& r:remap)
+      if(r==INVALID)
+        r = next++;
+
+    std::vector<WorldVertex> vertices(numVertices);
+    for(size_t v=0; v<numVertices; ++v)
+      vertices[remap[v]] = mesh.vertices[v];
+    mesh.vertices.swap(vertices);
+
+    if(mesh.verticesId.size()==numVertices) {
+      std::vector<uint32_t> ids(numVertices);
+      for(size_t v=0; v<numVertices; ++v)
+        ids[remap[v]] = mesh.verticesId[v];
+      mesh.verticesId.swap(ids);
+      }
+    }
+
+  /**
+   * @return 30 bit morton-code of a point in the unit cube
+   */
+  static uint32_t morton(float x, float y, float z) {
+    auto spread = [](float f) {
+      uint32_t v = uint32_t(std::min(std::max(f, 0.f), 1.f)*1023.f);
+      v = (v | (v<<16)) & 0x030000FF;
+      v = (v | (v<<8))  & 0x0300F00F;
+      v = (v | (v<<4))  & 0x030C30C3;
+      v = (v | (v<<2))  & 0x09249249;
+      return v;
+      };
+    return spread(x) | (spread(y)<<1) | (spread(z)<<2);
+    }
+
+  /**
+   * @brief Splits a triangle-list into clusters. Each cluster starts at the first triangle left in morton-order
+   *        of the centroids and grows over the triangles sharing the most vertices with it, or over seeds close
+   *        to it when nothing adjacent fits, so clusters stay small and round.
+   * @param localId one entry per vertex of the mesh, all INVALID. Left that way.
+   * @param order receives the triangles of the list in their new order
+   * @param clusterStart receives the first triangle of each cluster in the new order
+   */
+  static void growClusters(const uint32_t* indices, size_t numIndices, const std::vector<WorldVertex>& vertices,
+                           size_t maxVertices, size_t maxTriangles, std::vector<uint32_t>& localId,
+                           std::vector<uint32_t>& order, std::vector<uint32_t>& clusterStart) {
+    const size_t numTriangles = numIndices/3;
+    Adjacency    adj(indices, numIndices, localId);
+    const auto&  tri = adj.triangleVertices;
+
+    float bbox[2][3] = {{ 1e30f,  1e30f,  1e30f}, {-1e30f, -1e30f, -1e30f}};
+    for(size_t i=0; i<numIndices; ++i) {
+      const float* p = vertices[indices[i]].Position.v;
+      for(size_t k=0; k<3; ++k) {
+        bbox[0][k] = std::min(bbox[0][k], p[k]);
+        bbox[1][k] = std::max(bbox[1][k], p[k]);
+        }
+      }
+
+    // One scale for all axes: a flat world must not get as many bits for its height as for its width
+    float extent = 0;
+    for(size_t k=0; k<3; ++k)
+      extent = std::max(extent, bbox[1][k]-bbox[0][k]);
+
+    std::vector<std::pair<uint32_t,uint32_t>> seeds(numTriangles);
+    for(size_t t=0; t<numTriangles; ++t) {
+      float c[3];
+      for(size_t k=0; k<3; ++k) {
+        const float sum = vertices[indices[t*3]].Position.v[k] + vertices[indices[t*3+1]].Position.v[k] +
+                          vertices[indices[t*3+2]].Position.v[k];
+        c[k] = extent>0 ? (sum/3.f-bbox[0][k])/extent : 0.f;
+        }
+      seeds[t] = std::make_pair(morton(c[0], c[1], c[2]), uint32_t(t));
+      }
+    std::sort(seeds.begin(), seeds.end());
+
+    std::vector<uint8_t>  emitted(numTriangles, 0);
+    std::vector<uint32_t> vertexCluster(adj.numVertices, INVALID);
+    std::vector<uint32_t> candidates;
+    size_t                seedCursor  = 0;
+    size_t                numVertices = 0;
+    uint32_t              cluster     = INVALID;
+    float                 bounds[2][3] = {};
+
+    auto shared = [&](uint32_t t) {
+      size_t num = 0;
+      for(size_t k=0; k<3; ++k)
+        if(vertexCluster[tri[t*3+k]]==cluster)
+          ++num;
+      return num;
+      };
+
+    // Whether a triangle lies no further from the box of the cluster than the radii of both together,
+    // and the squared radius of the box with it
+    auto isNear = [&](uint32_t t, float& grown) {
+      float gap = 0, radius = 0, size = 0;
+      grown = 0;
+      for(size_t k=0; k<3; ++k) {
+        float lo = vertices[indices[t*3]].Position.v[k], hi = lo;
+        for(size_t i=1; i<3; ++i) {
+          lo = std::min(lo, vertices[indices[t*3+i]].Position.v[k]);
+          hi = std::max(hi, vertices[indices[t*3+i]].Position.v[k]);
+          }
+        const float d    = std::max(0.f, std::max(lo-bounds[1][k], bounds[0][k]-hi));
+        const float half = (bounds[1][k]-bounds[0][k])*0.5f;
+        const float both = (std::max(hi, bounds[1][k])-std::min(lo, bounds[0][k]))*0.5f;
+        gap    += d*d;
+        radius += half*half;
+        size   += (hi-lo)*(hi-lo)*0.25f;
+        grown  += both*both;
+        }
+      return std::sqrt(gap)<=std::sqrt(radius)+std::sqrt(size);
+      };
+
+    order.clear();
+    order.reserve(numTriangles);
+    clusterStart.clear();
+    while(order.size()<numTriangles) {
+      uint32_t next = INVALID;
+      if(cluster!=INVALID && order.size()-clusterStart.back()<maxTriangles) {
+        size_t best = 0;
+        for(auto t:candidates) {
+          const size_t s = shared(t);
+          if(emitted[t] || numVertices+3-s>maxVertices)
+            continue;
+          if(next==INVALID || s>best || (s==best && t<next)) {
+            next = t;
+            best = s;
+            }
+          }
+
+        if(next==INVALID) {
+          // Nothing adjacent fits anymore, one of the next seeds may still do: the one keeping the cluster
+          // smallest. Seeds far from the cluster are left for a new one, the next seed in morton-order can be
+          // anywhere.
+          while(emitted[seeds[seedCursor].second])
+            ++seedCursor;
+          float best = 0;
+          for(size_t i=seedCursor; i<numTriangles && i<seedCursor+SEED_WINDOW; ++i) {
+            const uint32_t t = seeds[i].second;
+            float          grown = 0;
+            if(emitted[t] || numVertices+3-shared(t)>maxVertices || !isNear(t, grown))
+              continue;
+            if(next==INVALID || grown<best) {
+              next = t;
+              best = grown;
+              }
+            }
+          }
+        }
+
+      if(next==INVALID) {
+        while(emitted[seeds[seedCursor].second])
+          ++seedCursor;
+        next = seeds[seedCursor].second;
+        cluster = uint32_t(clusterStart.size());
+        clusterStart.push_back(uint32_t(order.size()));
+        candidates.clear();
+        numVertices = 0;
+        for(size_t k=0; k<3; ++k) {
+          bounds[0][k] =  1e30f;
+          bounds[1][k] = -1e30f;
+          }
+        }
+
+      emitted[next] = 1;
+      order.push_back(next);
+      for(size_t i=0; i<3; ++i) {
+        const float* p = vertices[indices[next*3+i]].Position.v;
+        for(size_t k=0; k<3; ++k) {
+          bounds[0][k] = std::min(bounds[0][k], p[k]);
+          bounds[1][k] = std::max(bounds[1][k], p[k]);
+          }
+        }
+      for(size_t k=0; k<3; ++k) {
+        const uint32_t v = tri[next*3+k];
+        if(vertexCluster[v]==cluster)
+          continue;
+        vertexCluster[v] = cluster;
+        ++numVertices;
+        for(uint32_t i=adj.start[v]; i<adj.start[v+1]; ++i)
+          if(!emitted[adj.triangles[i]])
+            candidates.push_back(adj.triangles[i]);
+        }
+      candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](uint32_t t) { return emitted[t]!=0; }),
+                       candidates.end());
+      }
+    }
+
+  /**
+   * @brief Bounding box and -sphere of the vertices of a cluster, and the cone its triangles face into
+   * @param localId one entry per vertex of the mesh, all INVALID. Left that way.
+   */
+  static void clusterBounds(PackedMesh::Cluster& cl, const uint32_t* indices, const std::vector<WorldVertex>& vertices,
+                            std::vector<uint32_t>& localId) {
+    std::vector<uint32_t> used;
+    for(size_t i=0; i<cl.indexSize; ++i) {
+      if(localId[indices[i]]==INVALID) {
+        localId[indices[i]] = 0;
+        used.push_back(indices[i]);
+        }
+      }
+    for(auto v:used)
+      localId[v] = INVALID;
+
+    float bbox[2][3] = {{ 1e30f,  1e30f,  1e30f}, {-1e30f, -1e30f, -1e30f}};
+    for(auto v:used) {
+      const float* p = vertices[v].Position.v;
+      for(size_t k=0; k<3; ++k) {
+        bbox[0][k] = std::min(bbox[0][k], p[k]);
+        bbox[1][k] = std::max(bbox[1][k], p[k]);
+        }
+      }
+
+    float center[3], radius = 0;
+    for(size_t k=0; k<3; ++k) {
+      center[k] = (bbox[0][k]+bbox[1][k])*0.5f;
+      cl.bbox[0].v[k]        = bbox[0][k];
+      cl.bbox[1].v[k]        = bbox[1][k];
+      cl.sphereCenter.v[k]   = center[k];
+      cl.coneApex.v[k]       = center[k];
+      cl.coneAxis.v[k]       = 0;
+      }
+    for(auto v:used) {
+      const float* p = vertices[v].Position.v;
+      const float  d[3] = {p[0]-center[0], p[1]-center[1], p[2]-center[2]};
+      radius = std::max(radius, d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+      }
+    cl.sphereRadius = std::sqrt(radius);
+    cl.coneCutoff   = 2;
+
+    // Cone around the average normal, wide enough for all of them
+    const size_t       numTriangles = cl.indexSize/3;
+    std::vector<float> normals(numTriangles*3, 0.f);
+    float              axis[3] = {};
+    for(size_t t=0; t<numTriangles; ++t) {
+      const float* p0 = vertices[indices[t*3+0]].Position.v;
+      const float* p1 = vertices[indices[t*3+1]].Position.v;
+      const float* p2 = vertices[indices[t*3+2]].Position.v;
+      const float  e1[3] = {p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]};
+      const float  e2[3] = {p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2]};
+      float*       n     = &normals[t*3];
+      n[0] = e1[1]*e2[2]-e1[2]*e2[1];
+      n[1] = e1[2]*e2[0]-e1[0]*e2[2];
+      n[2] = e1[0]*e2[1]-e1[1]*e2[0];
+      const float len = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+      if(len<=0)
+        continue;  // Degenerate, faces nowhere
+      for(size_t k=0; k<3; ++k) {
+        n[k]    /= len;
+        axis[k] += n[k];
+        }
+      }
+    const float axisLen = std::sqrt(axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2]);
+    if(axisLen<=0)
+      return;
+    for(size_t k=0; k<3; ++k)
+      axis[k] /= axisLen;
+
+    float minDot = 1;
+    for(size_t t=0; t<numTriangles; ++t) {
+      const float* n = &normals[t*3];
+      if(n[0]==0 && n[1]==0 && n[2]==0)
+        continue;
+      minDot = std::min(minDot, axis[0]*n[0] + axis[1]*n[1] + axis[2]*n[2]);
+      }
+    if(minDot<=0.1f)
+      return;  // Wider than about 168°, the test would hardly ever succeed
+
+    // Move the apex back along the axis, until all triangle-planes are in front of it
+    float maxT = 0;
+    for(size_t t=0; t<numTriangles; ++t) {
+      const float* n  = &normals[t*3];
+      const float* p0 = vertices[indices[t*3]].Position.v;
+      const float  dc = axis[0]*n[0] + axis[1]*n[1] + axis[2]*n[2];
+      if(n[0]==0 && n[1]==0 && n[2]==0)
+        continue;
+      const float  dn = (center[0]-p0[0])*n[0] + (center[1]-p0[1])*n[1] + (center[2]-p0[2])*n[2];
+      maxT = std::max(maxT, dn/dc);
+      }
+    for(size_t k=0; k<3; ++k) {
+      cl.coneApex.v[k] = center[k] - axis[k]*maxT;
+      cl.coneAxis.v[k] = axis[k];
+      }
+    cl.coneCutoff = std::sqrt(1.f - minDot*minDot);
+    }
+}  // namespace internal
+
+float MeshOptimizer::acmr(const uint32_t* indices, size_t numIndices, size_t numVertices, size_t cacheSize) {
+  if(numIndices<3)
+    return 0;
+  internal::FifoCache fifo(numVertices, cacheSize);
+  return float(fifo.misses(indices, numIndices))/float(numIndices/3);
+  }
+
+MeshOptimizer::Stats MeshOptimizer::optimize(PackedMesh& mesh, const Options& options) {
+  Stats stats;
+  mesh.clusters.clear();
+  for(auto& sm:mesh.subMeshes) {
+    sm.clusterOffset = 0;
+    sm.clusterCount  = 0;
+    }
+  stats.acmrBefore = acmr(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), options.cacheSize);
+
+  std::vector<uint32_t> localId(mesh.vertices.size(), internal::INVALID);
+  std::vector<uint32_t> order;
+  internal::FifoCache   fifo(mesh.vertices.size(), options.cacheSize);
+  for(auto& sm:mesh.subMeshes) {
+    if(sm.indexSize<3 || sm.indexSize%3!=0 || sm.indexOffset+sm.indexSize>mesh.indices.size())
+      continue;
+    uint32_t* indices = mesh.indices.data()+sm.indexOffset;
+
+    internal::optimizeVertexCache(indices, sm.indexSize, localId, order);
+    internal::reorder(indices, sm.indexSize, order, internal::lightmaps(sm, 0));
+
+    if(options.optimizeOverdraw &&
+       internal::optimizeOverdraw(indices, sm.indexSize, mesh.vertices, fifo, options.overdrawThreshold, order))
+      internal::reorder(indices, sm.indexSize, order, internal::lightmaps(sm, 0));
+    }
+
+  if(options.optimizeVertexFetch)
+    internal::optimizeVertexFetch(mesh);
+
+  stats.acmrAfter = acmr(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), options.cacheSize);
+  return stats;
+  }
+
+void MeshOptimizer::buildClusters(PackedMesh& mesh, size_t maxVertices, size_t maxTriangles) {
+  maxVertices  = std::max<size_t>(maxVertices, 3);
+  maxTriangles = std::max<size_t>(maxTriangles, 1);
+
+  std::vector<uint32_t> localId(mesh.vertices.size(), internal::INVALID);
+  std::vector<uint32_t> order, clusterStart;
+  mesh.clusters.clear();
+  for(auto& sm:mesh.subMeshes) {
+    sm.clusterOffset = mesh.clusters.size();
+    sm.clusterCount  = 0;
+    if(sm.indexSize<3 || sm.indexSize%3!=0 || sm.indexOffset+sm.indexSize>mesh.indices.size())
+      continue;
+    uint32_t*    indices      = mesh.indices.data()+sm.indexOffset;
+    const size_t numTriangles = sm.indexSize/3;
+
+    internal::growClusters(indices, sm.indexSize, mesh.vertices, maxVertices, maxTriangles, localId, order, clusterStart);
+    internal::reorder(indices, sm.indexSize, order, internal::lightmaps(sm, 0));
+
+    for(size_t c=0; c<clusterStart.size(); ++c) {
+      const size_t first = clusterStart[c];
+      const size_t last  = c+1<clusterStart.size() ? clusterStart[c+1] : numTriangles;
+
+      internal::optimizeVertexCache(indices+first*3, (last-first)*3, localId, order);
+      internal::reorder(indices+first*3, (last-first)*3, order, internal::lightmaps(sm, first));
+
+      PackedMesh::Cluster cl;
+      cl.indexOffset = sm.indexOffset+first*3;
+      cl.indexSize   = (last-first)*3;
+      internal::clusterBounds(cl, indices+first*3, mesh.vertices, localId);
+      mesh.clusters.push_back(cl);
+      }
+    sm.clusterCount = clusterStart.size();
+    }
+
+  internal::optimizeVertexFetch(mesh);
+  }
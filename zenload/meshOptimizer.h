@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "zTypes.h"
+
+namespace ZenLoad
+{
+/**
+  * @brief Optional post-process for the output of zCMesh::packMesh() and zCProgMeshProto::packMesh(): reorders
+  *        the triangles of each sub-mesh for the post-transform vertex-cache of the GPU, then for less overdraw,
+  *        and finally the vertices in the order the triangles use them. The rendered result stays the same.
+  */
+namespace MeshOptimizer
+  {
+  struct Options
+  {
+    size_t cacheSize            = 16;     // FIFO-cache the ACMR is measured with
+    bool   optimizeOverdraw     = true;
+    float  overdrawThreshold    = 1.05f;  // How much worse the ACMR of a sub-mesh may get for less overdraw
+    bool   optimizeVertexFetch  = true;
+  };
+
+  struct Stats
+  {
+    float acmrBefore = 0;  // Average cache miss ratio: vertices transformed per triangle, 0.5 at best, 3 at worst
+    float acmrAfter  = 0;
+  };
+
+  /**
+    * @return ACMR of the given triangle-list with a FIFO-cache of the given size
+    */
+  float acmr(const uint32_t* indices, size_t numIndices, size_t numVertices, size_t cacheSize);
+
+  /**
+    * @brief Reorders indices and vertices of the mesh. Sub-meshes keep their index-ranges, the triangles of
+    *        PackedMesh::triangles and their order aren't touched. Clusters of the mesh are dropped.
+    */
+  Stats optimize(PackedMesh& mesh, const Options& options = Options());
+
+  /**
+    * @brief Splits each sub-mesh into PackedMesh::clusters of at most the given number of vertices and triangles,
+    *        with bounds to cull them by. Triangles are reordered inside their sub-mesh, so each cluster is a
+    *        contiguous index-range, and ordered for the vertex-cache inside the cluster. Vertices are renumbered
+    *        in the order the clusters use them. Run after optimize(), whose triangle-order this replaces.
+    */
+  void buildClusters(PackedMesh& mesh, size_t maxVertices = 64, size_t maxTriangles = 124);
+  }  // namespace MeshOptimizer
+}  // namespace ZenLoad
@@ -0,0 +1,403 @@
+#include "meshTiling.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "utils/logger.h"
+
+using namespace ZenLoad;
+
+namespace internal
+{
+  static const char     TILE_MAGIC[8] = {'Z','L','M','E','S','H','T','L'};
+  static const uint32_t TILE_VERSION  = 1;
+  static const uint32_t INVALID_TILE  = uint32_t(-1);
+
+#pragma pack(push, 1)
+  struct TileHeader
+  {
+    char          magic[8];
+    uint32_t      version;
+    uint32_t      vertexSize;  // Layout guard, vertices are stored as they are
+    uint64_t      numParts;
+    uint64_t      numVertices;
+    uint64_t      numIndices;
+    uint64_t      numLightmapIndices;
+    int32_t       x;
+    int32_t       z;
+    uint32_t      bspNode;
+    uint32_t      reserved;
+    ZMath::float3 bbox[2];
+  };
+
+  struct TilePart
+  {
+    uint64_t subMesh;
+    uint64_t indexOffset;  // Relative to the first index of the tile
+    uint64_t indexSize;
+  };
+#pragma pack(pop)
+
+  /**
+   * @brief Triangle of a sub-mesh, by the position of its first index
+   */
+  struct TileTriangle
+  {
+    size_t subMesh;
+    size_t index;
+  };
+
+  /**
+   * @return triangles of all sub-meshes with a valid index-range, in order
+   */
+  static std::vector<TileTriangle> triangles(const PackedMesh& mesh) {
+    std::vector<TileTriangle> ret;
+    ret.reserve(mesh.indices.size()/3);
+    for(size_t s=0; s<mesh.subMeshes.size(); ++s) {
+      const PackedMesh::SubMesh& sm = mesh.subMeshes[s];
+      if(sm.indexSize%3!=0 || sm.indexOffset>mesh.indices.size() || sm.indexSize>mesh.indices.size()-sm.indexOffset)
+        continue;
+      for(size_t i=0; i<sm.indexSize; i+=3)
+        ret.push_back({s, sm.indexOffset+i});
+      }
+    return ret;
+    }
+
+  static ZMath::float3 centroid(const PackedMesh& mesh, const TileTriangle& t) {
+    ZMath::float3 c;
+    for(size_t k=0; k<3; ++k) {
+      const ZMath::float3& p = mesh.vertices[mesh.indices[t.index+k]].Position;
+      for(size_t i=0; i<3; ++i)
+        c.v[i] += p.v[i]/3.f;
+      }
+    return c;
+    }
+
+  static void resetBBox(ZMath::float3 (&bbox)[2]) {
+    const float inf = std::numeric_limits<float>::infinity();
+    bbox[0] = ZMath::float3( inf,  inf,  inf);
+    bbox[1] = ZMath::float3(-inf, -inf, -inf);
+    }
+
+  static void growBBox(ZMath::float3 (&bbox)[2], const ZMath::float3& p) {
+    for(size_t i=0; i<3; ++i) {
+      bbox[0].v[i] = std::min(bbox[0].v[i], p.v[i]);
+      bbox[1].v[i] = std::max(bbox[1].v[i], p.v[i]);
+      }
+    }
+
+  /**
+   * @brief Fills the tiles already in out with the triangles assigned to them. Triangles stay in their order inside
+   *        a tile, which groups them by sub-mesh, vertices are numbered per tile in order of first use.
+   * @param tileOf tile of each triangle
+   */
+  static void fillTiles(const PackedMesh& mesh, const std::vector<TileTriangle>& tris,
+                        const std::vector<uint32_t>& tileOf, TiledMesh& out) {
+    const size_t numTiles = out.tiles.size();
+
+    // Counting-sort by tile
+    std::vector<size_t> start(numTiles+1, 0);
+    for(auto t:tileOf)
+      start[t+1]++;
+    for(size_t t=0; t<numTiles; ++t)
+      start[t+1] += start[t];
+    std::vector<uint32_t> sorted(tris.size());
+    std::vector<size_t>   fill(start.begin(), start.end()-1);
+    for(size_t i=0; i<tris.size(); ++i)
+      sorted[fill[tileOf[i]]++] = uint32_t(i);
+
+    bool hasLightmaps = !tris.empty();
+    for(auto& t:tris) {
+      const PackedMesh::SubMesh& sm = mesh.subMeshes[t.subMesh];
+      hasLightmaps &= sm.triangleLightmapIndices.size()==sm.indexSize/3;
+      }
+
+    out.vertices.clear();
+    out.indices.clear();
+    out.triangleLightmapIndices.clear();
+    out.parts.clear();
+    out.indices.reserve(tris.size()*3);
+
+    std::vector<uint32_t> localId(mesh.vertices.size(), INVALID_TILE);
+    std::vector<uint32_t> used;
+    resetBBox(out.bbox);
+    for(size_t t=0; t<numTiles; ++t) {
+      TiledMesh::Tile& tile = out.tiles[t];
+      tile.vertexOffset = out.vertices.size();
+      tile.indexOffset  = out.indices.size();
+      tile.partOffset   = out.parts.size();
+      resetBBox(tile.bbox);
+
+      for(size_t i=start[t]; i<start[t+1]; ++i) {
+        const TileTriangle& tri = tris[sorted[i]];
+        if(out.parts.size()==tile.partOffset || out.parts.back().subMesh!=tri.subMesh) {
+          TiledMesh::Part part;
+          part.subMesh     = tri.subMesh;
+          part.indexOffset = out.indices.size();
+          out.parts.push_back(part);
+          }
+        for(size_t k=0; k<3; ++k) {
+          const uint32_t v = mesh.indices[tri.index+k];
+          if(localId[v]==INVALID_TILE) {
+            localId[v] = uint32_t(used.size());
+            used.push_back(v);
+            out.vertices.push_back(mesh.vertices[v]);
+            growBBox(tile.bbox, mesh.vertices[v].Position);
+            }
+          out.indices.push_back(localId[v]);
+          }
+        out.parts.back().indexSize += 3;
+
+        if(hasLightmaps) {
+          const PackedMesh::SubMesh& sm = mesh.subMeshes[tri.subMesh];
+          out.triangleLightmapIndices.push_back(sm.triangleLightmapIndices[(tri.index-sm.indexOffset)/3]);
+          }
+        }
+
+      for(auto v:used)
+        localId[v] = INVALID_TILE;
+      used.clear();
+
+      tile.vertexCount = out.vertices.size()-tile.vertexOffset;
+      tile.indexSize   = out.indices.size()-tile.indexOffset;
+      tile.partCount   = out.parts.size()-tile.partOffset;
+      growBBox(out.bbox, tile.bbox[0]);
+      growBBox(out.bbox, tile.bbox[1]);
+      }
+
+    if(numTiles==0) {
+      out.bbox[0] = mesh.bbox[0];
+      out.bbox[1] = mesh.bbox[1];
+      }
+    }
+
+  static void append(std::vector<uint8_t>& out, const void* data, size_t size) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    out.insert(out.end(), p, p+size);
+    }
+
+  /**
+   * @brief Takes an array of count elements from the front of the data
+   * @return false if there aren't enough bytes left
+   */
+  static bool take(const uint8_t*& data, size_t& size, uint64_t count, size_t elemSize, const uint8_t*& array) {
+    if(count>size/elemSize)
+      return false;
+    array = data;
+    data += count*elemSize;
+    size -= size_t(count)*elemSize;
+    return true;
+    }
+}  // namespace internal
+
+void MeshTiling::buildGrid(const PackedMesh& mesh, float tileSize, TiledMesh& out) {
+  using namespace internal;
+  if(!(tileSize>0)) {
+    LogWarn() << "Invalid tile-size " << tileSize << ", the world-mesh ends up in a single tile";
+    tileSize = std::numeric_limits<float>::infinity();
+    }
+
+  // Cells sort by z, then x
+  auto cell = [](float f) {
+    const float c = std::floor(f);
+    return int32_t(std::min(std::max(c, float(std::numeric_limits<int32_t>::min())),
+                            float(std::numeric_limits<int32_t>::max())));
+    };
+  auto key = [](int32_t x, int32_t z) {
+    return (uint64_t(uint32_t(z)^0x80000000u)<<32) | uint64_t(uint32_t(x)^0x80000000u);
+    };
+
+  const std::vector<TileTriangle> tris = triangles(mesh);
+  std::vector<uint64_t>           keys(tris.size());
+  for(size_t i=0; i<tris.size(); ++i) {
+    const ZMath::float3 c = centroid(mesh, tris[i]);
+    keys[i] = key(cell(c.x/tileSize), cell(c.z/tileSize));
+    }
+
+  std::vector<uint64_t> cells = keys;
+  std::sort(cells.begin(), cells.end());
+  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+  std::vector<uint32_t> tileOf(tris.size());
+  for(size_t i=0; i<tris.size(); ++i)
+    tileOf[i] = uint32_t(std::lower_bound(cells.begin(), cells.end(), keys[i])-cells.begin());
+
+  out.tiles.assign(cells.size(), TiledMesh::Tile());
+  for(size_t t=0; t<cells.size(); ++t) {
+    out.tiles[t].x = int32_t(uint32_t(cells[t])^0x80000000u);
+    out.tiles[t].z = int32_t(uint32_t(cells[t]>>32)^0x80000000u);
+    }
+  fillTiles(mesh, tris, tileOf, out);
+  }
+
+void MeshTiling::buildBsp(const PackedMesh& mesh, const zCBspTreeData& bsp, float scale, size_t maxTriangles,
+                          TiledMesh& out) {
+  using namespace internal;
+  const std::vector<zCBspNode>&   nodes = bsp.nodes;
+  const std::vector<TileTriangle> tris  = triangles(mesh);
+  std::vector<uint32_t>           tileOf(tris.size(), 0);
+  if(nodes.empty()) {
+    LogWarn() << "World has no bsp-tree, the world-mesh ends up in a single tile";
+    out.tiles.assign(tris.empty() ? 0 : 1, TiledMesh::Tile());
+    fillTiles(mesh, tris, tileOf, out);
+    return;
+    }
+  if(!(scale>0))
+    scale = 1;
+
+  // Walk each triangle down to its leaf, or the last node on the way that has the child it belongs to
+  std::vector<uint32_t> stop(tris.size());
+  std::vector<size_t>   own(nodes.size(), 0);
+  for(size_t i=0; i<tris.size(); ++i) {
+    const ZMath::float3 c = centroid(mesh, tris[i]);
+    uint32_t            n = 0;
+    while(!nodes[n].isLeaf()) {
+      const ZMath::float4& plane = nodes[n].plane;
+      const float          d     = (plane.x*c.x + plane.y*c.y + plane.z*c.z)/scale - plane.w;
+      const uint32_t       next  = d>=0 ? nodes[n].front : nodes[n].back;
+      if(next==zCBspNode::INVALID_NODE || next>=nodes.size())
+        break;
+      n = next;
+      }
+    stop[i] = n;
+    own[n]++;
+    }
+
+  // Children always come after their parent
+  std::vector<size_t> subtree = own;
+  for(size_t n=nodes.size(); n-->1;) {
+    const uint32_t parent = nodes[n].parent;
+    if(parent<n)
+      subtree[parent] += subtree[n];
+    }
+
+  // Cut the tree top-down where the subtrees are small enough. Triangles kept by a node that is cut further get
+  // a tile of their own.
+  std::vector<uint32_t> covered(nodes.size(), INVALID_TILE);
+  std::vector<uint32_t> ownTile(nodes.size(), INVALID_TILE);
+  out.tiles.clear();
+  auto newTile = [&](size_t n) {
+    TiledMesh::Tile tile;
+    tile.bspNode = uint32_t(n);
+    out.tiles.push_back(tile);
+    return uint32_t(out.tiles.size()-1);
+    };
+  for(size_t n=0; n<nodes.size(); ++n) {
+    const uint32_t parent = nodes[n].parent;
+    if(parent<n && covered[parent]!=INVALID_TILE)
+      covered[n] = covered[parent];
+    else if(subtree[n]==0)
+      continue;
+    else if(subtree[n]<=maxTriangles || nodes[n].isLeaf())
+      covered[n] = newTile(n);
+    else if(own[n]>0)
+      ownTile[n] = newTile(n);
+    }
+
+  for(size_t i=0; i<tris.size(); ++i)
+    tileOf[i] = covered[stop[i]]!=INVALID_TILE ? covered[stop[i]] : ownTile[stop[i]];
+  fillTiles(mesh, tris, tileOf, out);
+  }
+
+void MeshTiling::writeTile(const TiledMesh& mesh, size_t tile, std::vector<uint8_t>& out) {
+  using namespace internal;
+  const TiledMesh::Tile& t = mesh.tiles[tile];
+  const bool hasLightmaps  = mesh.triangleLightmapIndices.size()==mesh.indices.size()/3;
+
+  TileHeader h = {};
+  std::memcpy(h.magic, TILE_MAGIC, sizeof(h.magic));
+  h.version            = TILE_VERSION;
+  h.vertexSize         = uint32_t(sizeof(WorldVertex));
+  h.numParts           = t.partCount;
+  h.numVertices        = t.vertexCount;
+  h.numIndices         = t.indexSize;
+  h.numLightmapIndices = hasLightmaps ? t.indexSize/3 : 0;
+  h.x                  = t.x;
+  h.z                  = t.z;
+  h.bspNode            = t.bspNode;
+  h.bbox[0]            = t.bbox[0];
+  h.bbox[1]            = t.bbox[1];
+
+  out.clear();
+  out.reserve(sizeof(h) + t.partCount*sizeof(TilePart) + t.vertexCount*sizeof(WorldVertex) +
+              t.indexSize*sizeof(uint32_t) + h.numLightmapIndices*sizeof(int16_t));
+  append(out, &h, sizeof(h));
+  for(size_t i=0; i<t.partCount; ++i) {
+    const TiledMesh::Part& p    = mesh.parts[t.partOffset+i];
+    const TilePart         part = {p.subMesh, p.indexOffset-t.indexOffset, p.indexSize};
+    append(out, &part, sizeof(part));
+    }
+  append(out, mesh.vertices.data()+t.vertexOffset, t.vertexCount*sizeof(WorldVertex));
+  append(out, mesh.indices.data()+t.indexOffset,   t.indexSize*sizeof(uint32_t));
+  if(hasLightmaps)
+    append(out, mesh.triangleLightmapIndices.data()+t.indexOffset/3, h.numLightmapIndices*sizeof(int16_t));
+  }
+
+bool MeshTiling::readTile(const uint8_t* data, size_t size, TiledMesh& tile) {
+  using namespace internal;
+  TileHeader h = {};
+  if(size<sizeof(h)) {
+    LogError() << "Mesh tile is broken";
+    return false;
+    }
+  std::memcpy(&h, data, sizeof(h));
+  if(std::memcmp(h.magic, TILE_MAGIC, sizeof(h.magic))!=0 || h.version!=TILE_VERSION ||
+     h.vertexSize!=sizeof(WorldVertex)) {
+    LogWarn() << "Mesh tile was written by a different version";
+    return false;
+    }
+  data += sizeof(h);
+  size -= sizeof(h);
+
+  const uint8_t* parts     = nullptr;
+  const uint8_t* vertices  = nullptr;
+  const uint8_t* indices   = nullptr;
+  const uint8_t* lightmaps = nullptr;
+  bool ok = take(data, size, h.numParts,           sizeof(TilePart),    parts)    &&
+            take(data, size, h.numVertices,        sizeof(WorldVertex), vertices) &&
+            take(data, size, h.numIndices,         sizeof(uint32_t),    indices)  &&
+            take(data, size, h.numLightmapIndices, sizeof(int16_t),     lightmaps);
+  ok &= h.numLightmapIndices==0 || h.numLightmapIndices==h.numIndices/3;
+  if(!ok) {
+    LogError() << "Mesh tile is broken";
+    return false;
+    }
+
+  tile.vertices.resize(size_t(h.numVertices));
+  tile.indices.resize(size_t(h.numIndices));
+  tile.triangleLightmapIndices.resize(size_t(h.numLightmapIndices));
+  tile.parts.resize(size_t(h.numParts));
+  std::memcpy(tile.vertices.data(), vertices, tile.vertices.size()*sizeof(WorldVertex));
+  std::memcpy(tile.indices.data(),  indices,  tile.indices.size()*sizeof(uint32_t));
+  std::memcpy(tile.triangleLightmapIndices.data(), lightmaps, tile.triangleLightmapIndices.size()*sizeof(int16_t));
+  for(size_t i=0; i<tile.parts.size(); ++i) {
+    TilePart p = {};
+    std::memcpy(&p, parts+i*sizeof(TilePart), sizeof(p));
+    ok &= p.indexOffset<=h.numIndices && p.indexSize<=h.numIndices-p.indexOffset;
+    tile.parts[i].subMesh     = size_t(p.subMesh);
+    tile.parts[i].indexOffset = size_t(p.indexOffset);
+    tile.parts[i].indexSize   = size_t(p.indexSize);
+    }
+  for(auto i:tile.indices)
+    ok &= i<h.numVertices;
+
+  TiledMesh::Tile t;
+  t.vertexCount = tile.vertices.size();
+  t.indexSize   = tile.indices.size();
+  t.partCount   = tile.parts.size();
+  t.bbox[0]     = h.bbox[0];
+  t.bbox[1]     = h.bbox[1];
+  t.x           = h.x;
+  t.z           = h.z;
+  t.bspNode     = h.bspNode;
+  tile.tiles.assign(1, t);
+  tile.bbox[0] = h.bbox[0];
+  tile.bbox[1] = h.bbox[1];
+
+  if(!ok) {
+    LogError() << "Mesh tile is broken";
+    tile = TiledMesh();
+    }
+  return ok;
+  }
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "zTypes.h"
+
+namespace ZenLoad
+{
+/**
+  * @brief Splits the packed world-mesh into tiles to stream, either by a grid on the XZ-plane or by subtrees of the
+  *        bsp-tree. Every triangle goes to the tile its centroid is in, vertices shared between tiles are copied,
+  *        so each tile works on its own. Inside a tile the triangles are grouped by sub-mesh and keep their order,
+  *        the materials stay with the sub-meshes of the PackedMesh.
+  */
+namespace MeshTiling
+  {
+  /**
+    * @brief Cells of the given size, counted from the origin, so the tile of a position doesn't depend on the world
+    */
+  void buildGrid(const PackedMesh& mesh, float tileSize, TiledMesh& out);
+
+  /**
+    * @brief Subtrees of the bsp-tree of the world with at most the given number of triangles, as far as the
+    *        leafs allow. Tiles follow the splitting planes of the tree.
+    * @param scale the world-mesh was packed with, see zCMesh::packMesh()
+    */
+  void buildBsp(const PackedMesh& mesh, const zCBspTreeData& bsp, float scale, size_t maxTriangles, TiledMesh& out);
+
+  /**
+    * @brief Stores a single tile with its vertices, indices, parts and lightmap-indices
+    */
+  void writeTile(const TiledMesh& mesh, size_t tile, std::vector<uint8_t>& out);
+
+  /**
+    * @brief Replaces the contents of the given mesh with a tile stored by writeTile()
+    * @return false if the data is broken or was written by a build with a different vertex-layout
+    */
+  bool readTile(const uint8_t* data, size_t size, TiledMesh& tile);
+  }  // namespace MeshTiling
+}  // namespace ZenLoad
@@ -1,6 +1,8 @@
 #include "parserImpl.h"
 
 #include <cctype>
+#include <cstring>
+#include <string_view>
 
 ZenLoad::ParserImpl::ParserImpl(ZenParser* parser)
     : m_pParser(parser)
@@ -85,12 +87,20 @@ bool ZenLoad::ParserImpl::parseHeader(ZenLoad::ZenParser::ChunkHeader& header, c
   return true;
   }
 
-ZenLoad::ZenParser::ZenClass ZenLoad::ParserImpl::parseClassName(const char* name, size_t len) {
-  static const std::initializer_list<std::pair<const char*,ZenLoad::ZenParser::ZenClass>> cls =
+namespace
+{
+  struct ClassName
+  {
+    std::string_view             name;
+    ZenLoad::ZenParser::ZenClass cls;
+  };
+
+  using ZenLoad::ZenParser;
+
+  constexpr ClassName CLASS_NAMES[] =
   {
     {"",                                                 ZenParser::zUnknown                    },
     {"\xA7",                                             ZenParser::zReference                  },
-    {"\xa7",                                             ZenParser::zReference                  },
     {"zCCSLib",                                          ZenParser::zCCSLib                     },
     {"zCCSBlock",                                        ZenParser::zCCSBlock                   },
     {"zCCSAtomicBlock",                                  ZenParser::zCCSAtomicBlock             },
@@ -167,7 +177,6 @@ ZenLoad::ZenParser::ZenClass ZenLoad::ParserImpl::parseClassName(const char* nam
     {"oCMsgManipulate:oCNpcMessage:zCEventMessage",      ZenParser::oCMsgManipulate             },
     {"zCEventScreenFX:zCEventMessage",                   ZenParser::zCEventScreenFX             },
     {"zCCSCamera_EventMsgActivate:zCEventMessage",       ZenParser::zCCSCamera_EventMsgActivate },
-    {"zCCSCamera_EventMsg:zCEventMessage",               ZenParser::zCCSCamera_EventMsg         },
     {"oCMsgAttack:oCNpcMessage:zCEventMessage",          ZenParser::oCMsgAttack                 },
     {"ocMsgDamage:oCNpcMessage:zCEventMessage",          ZenParser::oCMsgDamage                 },
     {"oCMsgMagic:oCNpcMessage:zCEventMessage",           ZenParser::oCMsgMagic                  },
@@ -182,43 +191,69 @@ ZenLoad::ZenParser::ZenClass ZenLoad::ParserImpl::parseClassName(const char* nam
     {"zCEventMusicControler:zCEventMessage",             ZenParser::zCEventMusicControler       }
   };
 
-  for(auto& i:cls) {
-    if(std::strlen(i.first)==len && std::memcmp(i.first,name,len)==0)
-      return i.second;
+  constexpr size_t   NUM_CLASS_NAMES  = sizeof(CLASS_NAMES)/sizeof(CLASS_NAMES[0]);
+  constexpr size_t   CLASS_SLOTS      = 2048;
+  constexpr uint8_t  CLASS_SLOT_EMPTY = 0xFF;
+  static_assert(NUM_CLASS_NAMES<CLASS_SLOT_EMPTY, "Slots can't index all class names");
+
+  constexpr uint64_t readWord(const char* name, size_t len) {
+    uint64_t w = 0;
+    for(size_t i=0; i<len && i<8; ++i)
+      w |= uint64_t(uint8_t(name[i])) << (i*8);
+    return w;
     }
-  return ZenParser::zUnknown;
-  }
 
-size_t ZenLoad::ParserImpl::valueTypeSize(ZenLoad::ParserImpl::EZenValueType type) {
-  switch(type) {
-    // Byte sized
-    case ZVT_BOOL:
-    case ZVT_BYTE:
-    case ZVT_ENUM:
-      return sizeof(uint8_t);
-    case ZVT_WORD:
-      return sizeof(uint16_t);
-    // 32-bit
-    case ZVT_INT:
-    case ZVT_HASH:
-    case ZVT_FLOAT:
-    case ZVT_COLOR:
-      return sizeof(uint32_t);
-    case ZVT_VEC3:
-      return sizeof(float)*3;
-    // Raw
-    case ZVT_RAW_FLOAT:
-    case ZVT_RAW:
-    case ZVT_STRING:
-    case ZVT_0:
-      return 0;
-    case ZVT_10:
-    case ZVT_11:
-    case ZVT_12:
-    case ZVT_13:
-    case ZVT_14:
-    case ZVT_15:
-      return 0;
+  // Only looks at the length and the first and last 8 bytes. makeClassTable() fails to compile once that
+  // doesn't tell all class names apart anymore.
+  constexpr uint32_t hashClassName(const char* name, size_t len, uint32_t seed) {
+    const size_t tail = len<8 ? 0 : len-8;
+    uint64_t h = (uint64_t(seed) << 32) ^ len;
+    h = (h ^ readWord(name,len)) * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 29) ^ readWord(name+tail,len-tail)) * 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 32;
+    return uint32_t(h);
     }
-  return 0;
+
+  struct ClassTable
+  {
+    uint32_t seed               = 0;
+    uint8_t  slots[CLASS_SLOTS] = {};
+  };
+
+  // Tries seeds until every class name gets a slot of its own, so a lookup is a single compare
+  constexpr ClassTable makeClassTable() {
+    ClassTable t;
+    for(uint32_t seed=1; seed<4096; ++seed) {
+      uint64_t used[CLASS_SLOTS/64] = {};
+      bool     collision = false;
+      for(size_t i=0; i<NUM_CLASS_NAMES && !collision; ++i) {
+        const size_t slot = hashClassName(CLASS_NAMES[i].name.data(),CLASS_NAMES[i].name.size(),seed) & (CLASS_SLOTS-1);
+        collision = (used[slot/64] >> (slot%64)) & 1;
+        used[slot/64] |= uint64_t(1) << (slot%64);
+        }
+      if(collision)
+        continue;
+
+      t.seed = seed;
+      for(auto& s:t.slots)
+        s = CLASS_SLOT_EMPTY;
+      for(size_t i=0; i<NUM_CLASS_NAMES; ++i)
+        t.slots[hashClassName(CLASS_NAMES[i].name.data(),CLASS_NAMES[i].name.size(),seed) & (CLASS_SLOTS-1)] = uint8_t(i);
+      return t;
+      }
+    throw "No collision-free seed for the class names";
+    }
+
+  constexpr ClassTable CLASS_TABLE = makeClassTable();
+}  // namespace
+
+ZenLoad::ZenParser::ZenClass ZenLoad::ParserImpl::parseClassName(const char* name, size_t len) {
+  const uint32_t h    = hashClassName(name,len,CLASS_TABLE.seed);
+  const uint8_t  slot = CLASS_TABLE.slots[h & (CLASS_SLOTS-1)];
+  if(slot==CLASS_SLOT_EMPTY)
+    return ZenParser::zUnknown;
+  const ClassName& c = CLASS_NAMES[slot];
+  if(c.name.size()==len && std::memcmp(c.name.data(),name,len)==0)
+    return c.cls;
+  return ZenParser::zUnknown;
   }
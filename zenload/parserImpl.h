@@ -102,5 +102,40 @@ private:
 friend class ParserImplBinary;
 friend class ParserImplBinSafe;
 friend class ParserImplASCII;
+template<class> friend class EntryReader;
   };
+
+inline size_t ParserImpl::valueTypeSize(EZenValueType type) {
+  switch(type) {
+    // Byte sized
+    case ZVT_BOOL:
+    case ZVT_BYTE:
+    case ZVT_ENUM:
+      return sizeof(uint8_t);
+    case ZVT_WORD:
+      return sizeof(uint16_t);
+    // 32-bit
+    case ZVT_INT:
+    case ZVT_HASH:
+    case ZVT_FLOAT:
+    case ZVT_COLOR:
+      return sizeof(uint32_t);
+    case ZVT_VEC3:
+      return sizeof(float)*3;
+    // Raw
+    case ZVT_RAW_FLOAT:
+    case ZVT_RAW:
+    case ZVT_STRING:
+    case ZVT_0:
+      return 0;
+    case ZVT_10:
+    case ZVT_11:
+    case ZVT_12:
+    case ZVT_13:
+    case ZVT_14:
+    case ZVT_15:
+      return 0;
+    }
+  return 0;
+  }
 }  // namespace ZenLoad
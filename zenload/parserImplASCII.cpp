@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cctype>
 #include "utils/logger.h"
+#include "asciiScan.h"
 
 using namespace ZenLoad;
 
@@ -25,12 +26,11 @@ bool ParserImplASCII::readChunkStart(ZenParser::ChunkHeader& header) {
     return false;
     }
 
-  size_t tmpSeek = m_pParser->m_Seek;
-  while(m_pParser->m_Data[tmpSeek] != ']') {
-    if(m_pParser->m_Data[tmpSeek] == '\r' || m_pParser->m_Data[tmpSeek] == '\n')
-      throw std::runtime_error("Invalid vob descriptor");
-    ++tmpSeek;
-    }
+  const uint8_t* desc     = m_pParser->m_Data + m_pParser->m_Seek;
+  const size_t   descSize = m_pParser->m_DataSize - m_pParser->m_Seek;
+  const size_t   descEnd  = AsciiScan::findAny<']','\r','\n'>(desc,descSize);
+  if(descEnd==descSize || desc[descEnd]!=']')
+    throw std::runtime_error("Invalid vob descriptor");
 
   // Parse chunk-header
   char        vobDescStk[256] = {};
@@ -3,9 +3,10 @@
 
 namespace ZenLoad
 {
-class ParserImplASCII : public ParserImpl
+class ParserImplASCII final : public ParserImpl
   {
   friend ZenParser;
+  template<class> friend class EntryReader;
 
 public:
   ParserImplASCII(ZenParser* parser);
@@ -1,4 +1,5 @@
 #include "parserImplBinSafe.h"
+#include <cctype>
 #include <utils/logger.h>
 
 using namespace ZenLoad;
@@ -78,34 +79,73 @@ void ParserImplBinSafe::readImplHeader() {
   size_t s = m_pParser->m_Seek;
   m_pParser->m_Seek = m_pParser->m_Header.binSafeHeader.bsHashTableOffset;
 
-  struct BinSafeEntry {
-    std::string key;
-    uint16_t insertionIndex;
-    };
-
-  std::unordered_map<uint32_t, std::vector<BinSafeEntry>> map;
   uint32_t htSize = m_pParser->readBinaryDWord();
+  m_Keys.clear();
+  m_Keys.reserve(htSize);
   for (uint32_t i = 0; i < htSize; i++) {
     uint16_t keyLen = m_pParser->readBinaryWord();
     uint16_t insIdx = m_pParser->readBinaryWord();
     uint32_t hashValue = m_pParser->readBinaryDWord();
 
-    (void)insIdx;
     (void)hashValue;
 
-    // Read the keys data from the archive
-    std::vector<uint8_t> keyData(keyLen);
-    m_pParser->readBinaryRaw(keyData.data(), keyLen);
+    // Entries refer to their key by insertion index
+    if(insIdx>=m_Keys.size())
+      m_Keys.resize(insIdx+1u);
+    m_Keys[insIdx].resize(keyLen);
+    if(keyLen>0)
+      m_pParser->readBinaryRaw(&m_Keys[insIdx][0], keyLen);
+    }
 
-    // Put the source key together with the insertion index into the map
-    //std::string key(keyData.begin(), keyData.end());
-    //map[hashValue].push_back( {key, insIdx} );
+  m_KeyIds.clear();
+  m_KeyIdByName.clear();
+  m_KeyNames.clear();
+  for(uint32_t i=0; i<m_Keys.size(); ++i) {
+    std::string key = m_Keys[i];
+    for(auto& c:key)
+      c = char(std::tolower(uint8_t(c)));
+    m_KeyIds.emplace(std::move(key),i);
     }
+  m_PendingKey = NO_KEY;
 
   // Restore old position
   m_pParser->m_Seek = s;
   }
 
+void ParserImplBinSafe::readKey() {
+  auto t = static_cast<EZenValueType>(m_pParser->readBinaryByte());
+  if(t != ZVT_HASH) {
+    m_pParser->m_Seek -= sizeof(uint8_t);
+    return;
+    }
+  m_PendingKey     = m_pParser->readBinaryDWord();
+  m_PendingKeySeek = m_pParser->m_Seek;
+  }
+
+uint32_t ParserImplBinSafe::currentKey() const {
+  // Anything moving the seek around makes the key refer to a different entry
+  if(m_PendingKeySeek!=m_pParser->m_Seek || m_PendingKey>=m_Keys.size())
+    return NO_KEY;
+  return m_PendingKey;
+  }
+
+uint32_t ParserImplBinSafe::keyId(const char* name) {
+  auto cached = m_KeyIdByName.find(std::string_view(name));
+  if(cached!=m_KeyIdByName.end())
+    return cached->second;
+
+  std::string key = name;
+  for(auto& c:key)
+    c = char(std::tolower(uint8_t(c)));
+  auto     it = m_KeyIds.find(key);
+  uint32_t id = it!=m_KeyIds.end() ? it->second : NO_KEY;
+
+  // The deque keeps its strings in place, so the views stay valid
+  m_KeyNames.emplace_back(name);
+  m_KeyIdByName.emplace(std::string_view(m_KeyNames.back()),id);
+  return id;
+  }
+
 /**
 * @brief Reads a string
 */
@@ -124,11 +164,7 @@ std::string ParserImplBinSafe::readString() {
   m_pParser->readBinaryRaw(&str[0], size);
 
   // Skip potential hash-value at the end of the string
-  auto t = static_cast<EZenValueType>(m_pParser->readBinaryByte());
-  if (t != ZVT_HASH)
-      m_pParser->m_Seek -= sizeof(uint8_t);
-  else
-      m_pParser->m_Seek += sizeof(uint32_t);
+  readKey();
 
   return str;
   }
@@ -150,11 +186,7 @@ bool ParserImplBinSafe::readString(char* buf, size_t bufSize) {
   buf[size] = '\0';
 
   // Skip potential hash-value at the end of the string
-  auto t = static_cast<EZenValueType>(m_pParser->readBinaryByte());
-  if (t != ZVT_HASH)
-      m_pParser->m_Seek -= sizeof(uint8_t);
-  else
-      m_pParser->m_Seek += sizeof(uint32_t);
+  readKey();
   return true;
   }
 
@@ -176,8 +208,13 @@ void ParserImplBinSafe::readEntryImpl(const char *expectedName, void* target, si
   size_t        size = 0;
 
   size_t seek=0;
-  if(optional)
+  if(optional) {
+    // The key tells whether this entry is the one asked for, before anything of it is read
+    const uint32_t key = currentKey();
+    if(key!=NO_KEY && expectedName!=nullptr && expectedName[0]!='\0' && key!=keyId(expectedName))
+      return;
     seek=m_pParser->getSeek();
+    }
 
   // Read type and size of the entry
   readTypeAndSizeBinSafe(realType, size);
@@ -276,11 +313,7 @@ void ParserImplBinSafe::readEntryImpl(const char *expectedName, void* target, si
     }
 
   // Skip potential hash-value at the end of the entry
-  auto t = static_cast<EZenValueType>(m_pParser->readBinaryByte());
-  if(t != ZVT_HASH)
-    m_pParser->m_Seek -= sizeof(uint8_t);
-  else
-    m_pParser->m_Seek += sizeof(uint32_t);
+  readKey();
   }
 
 /**
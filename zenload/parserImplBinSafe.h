@@ -1,11 +1,19 @@
 #pragma once
+#include <cstring>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
 #include "parserImpl.h"
 
 namespace ZenLoad
 {
-  class ParserImplBinSafe : public ParserImpl
+  class ParserImplBinSafe final : public ParserImpl
   {
     friend ZenParser;
+    template<class> friend class EntryReader;
 
   public:
     ParserImplBinSafe(ZenParser* parser);
@@ -43,10 +51,69 @@ namespace ZenLoad
       */
     void readEntryType(EZenValueType& type, size_t& size) override;
 
+    /**
+      * @brief Reads a fixed-size value if it is stored with exactly the expected type, the common case.
+      *        Returns false without reading anything otherwise, readEntryImpl() has to handle it then.
+      */
+    bool readValueFast(EZenValueType expectedType, void* target, size_t targetSize);
+
   private:
+    static const uint32_t NO_KEY = uint32_t(-1);
+
     /**
       * @brief reads the small header in front of datatypes
       */
     void readTypeAndSizeBinSafe(EZenValueType& type, size_t& size);
+
+    /**
+      * @brief Reads the key following a value, if there is one. It names the entry coming next.
+      */
+    void readKey();
+
+    /**
+      * @return ID of the key naming the entry at the current position, NO_KEY if unknown
+      */
+    uint32_t currentKey() const;
+
+    /**
+      * @return ID of the key with the given name, NO_KEY if the archive doesn't use it. Cached per name, so
+      *         names built in reused buffers are fine.
+      */
+    uint32_t keyId(const char* name);
+
+    /**
+      * @brief Keys of the archive by insertion index, as stored in its hash-table
+      */
+    std::vector<std::string>                          m_Keys;
+    std::unordered_map<std::string, uint32_t>         m_KeyIds;  // Lower-cased key -> index into m_Keys
+    std::unordered_map<std::string_view, uint32_t>    m_KeyIdByName;  // Views into m_KeyNames
+    std::deque<std::string>                           m_KeyNames;
+
+    uint32_t                                          m_PendingKey     = NO_KEY;
+    size_t                                            m_PendingKeySeek = 0;
   };
+
+  inline bool ParserImplBinSafe::readValueFast(EZenValueType expectedType, void* target, size_t targetSize) {
+    // Bools are stored as 4 bytes and colors reordered, those go the long way
+    if(expectedType!=ZVT_INT && expectedType!=ZVT_FLOAT && expectedType!=ZVT_BYTE &&
+       expectedType!=ZVT_WORD && expectedType!=ZVT_VEC3)
+      return false;
+
+    const uint8_t* data = m_pParser->m_Data;
+    size_t         at   = m_pParser->m_Seek;
+    if(at+1+targetSize>m_pParser->m_DataSize || data[at]!=expectedType || valueTypeSize(expectedType)!=targetSize)
+      return false;
+
+    std::memcpy(target, data+at+1, targetSize);
+    at += 1+targetSize;
+
+    // Same as readKey()
+    if(at+5<=m_pParser->m_DataSize && data[at]==ZVT_HASH) {
+      std::memcpy(&m_PendingKey, data+at+1, sizeof(m_PendingKey));
+      at += 5;
+      m_PendingKeySeek = at;
+      }
+    m_pParser->m_Seek = at;
+    return true;
+    }
 }  // namespace ZenLoad
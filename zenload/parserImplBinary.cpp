@@ -63,27 +63,6 @@ bool ParserImplBinary::readString(char* buf, size_t size) {
   return m_pParser->readLine(buf,size);
   }
 
-/**
- * @brief Reads data of the expected type. Throws if the read type is not the same as specified and not 0
- */
-void ParserImplBinary::readEntryImpl(const char* /*expectedName*/, void* target, size_t targetSize, EZenValueType expectedType, bool /*optional*/) {
-  // if(optional) // FIXME: handle this
-  //   LogInfo() << "Reading optional in binary archive - not implemented";
-
-  // Special case for strings, they're read until 0-bytes
-  if(expectedType == ZVT_STRING) {
-    *reinterpret_cast<std::string*>(target) = m_pParser->readLine(false);
-    return;
-    }
-
-  size_t size = 0;
-  if(expectedType==ZVT_RAW || expectedType==ZVT_RAW_FLOAT)
-    size = targetSize; else
-    size = ParserImpl::valueTypeSize(expectedType);
-
-  m_pParser->readBinaryRaw(target, size);
-  }
-
 /**
 * @brief Reads the type of a single entry
 */
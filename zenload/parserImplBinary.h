@@ -1,11 +1,14 @@
 #pragma once
+#include <cstring>
+
 #include "parserImpl.h"
 
 namespace ZenLoad
 {
-class ParserImplBinary : public ParserImpl
+class ParserImplBinary final : public ParserImpl
   {
   friend ZenParser;
+  template<class> friend class EntryReader;
 
 public:
   ParserImplBinary(ZenParser* parser);
@@ -44,4 +47,30 @@ protected:
     */
   void readEntryType(EZenValueType& type, size_t& size) override;
   };
+
+/**
+ * @brief Defined here, so the calls EntryReader makes with a known type can be inlined
+ */
+inline void ParserImplBinary::readEntryImpl(const char* /*expectedName*/, void* target, size_t targetSize, EZenValueType expectedType, bool /*optional*/) {
+  // if(optional) // FIXME: handle this
+  //   LogInfo() << "Reading optional in binary archive - not implemented";
+
+  // Special case for strings, they're read until 0-bytes
+  if(expectedType == ZVT_STRING) {
+    *reinterpret_cast<std::string*>(target) = m_pParser->readLine(false);
+    return;
+    }
+
+  size_t size = 0;
+  if(expectedType==ZVT_RAW || expectedType==ZVT_RAW_FLOAT)
+    size = targetSize; else
+    size = ParserImpl::valueTypeSize(expectedType);
+
+  if(m_pParser->m_StreamingWindow>0 || size==0) {
+    m_pParser->readBinaryRaw(target, size);
+    return;
+    }
+  std::memcpy(target, m_pParser->m_Data+m_pParser->m_Seek, size);
+  m_pParser->m_Seek += size;
+  }
 }  // namespace ZenLoad
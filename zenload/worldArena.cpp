@@ -0,0 +1,32 @@
+#include "worldArena.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace ZenLoad;
+
+void* WorldArena::allocate(size_t size, size_t align) {
+  size_t pad = (align - reinterpret_cast<uintptr_t>(m_At) % align) % align;
+  if(m_At==nullptr || pad+size>m_Left) {
+    // Oversized requests get a block of their own
+    const size_t blockSize = std::max(BLOCK_SIZE, size+align);
+    m_Blocks.emplace_back(new uint8_t[blockSize]);
+    m_At        = m_Blocks.back().get();
+    m_Left      = blockSize;
+    m_Capacity += blockSize;
+    pad         = (align - reinterpret_cast<uintptr_t>(m_At) % align) % align;
+    }
+
+  uint8_t* ret = m_At+pad;
+  m_At   += pad+size;
+  m_Left -= pad+size;
+  return ret;
+  }
+
+std::string_view WorldArena::store(std::string_view str) {
+  if(str.empty())
+    return std::string_view();
+  char* dst = allocate<char>(str.size());
+  std::memcpy(dst, str.data(), str.size());
+  return std::string_view(dst, str.size());
+  }
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "zTypes.h"
+#include "zenParser.h"
+
+namespace ZenLoad
+{
+  /**
+   * @brief Monotonic allocator: memory is handed out from large blocks and only given back all at once,
+   *        when the arena is destroyed
+   */
+  class WorldArena
+  {
+  public:
+    WorldArena() = default;
+    WorldArena(WorldArena&&) = default;
+    WorldArena& operator=(WorldArena&&) = default;
+    WorldArena(const WorldArena&) = delete;
+    WorldArena& operator=(const WorldArena&) = delete;
+
+    /**
+      * @return size bytes with the given alignment, which stay valid as long as the arena
+      */
+    void* allocate(size_t size, size_t align);
+
+    /**
+      * @return uninitialized space for n objects. Destructors are never run, so only trivial types may be used.
+      */
+    template<class T>
+    T* allocate(size_t n) {
+      static_assert(std::is_trivially_destructible<T>::value, "arena never runs destructors");
+      return static_cast<T*>(allocate(n*sizeof(T), alignof(T)));
+      }
+
+    /**
+      * @return copy of the string, owned by the arena
+      */
+    std::string_view store(std::string_view str);
+
+    /**
+      * @return bytes taken from the system so far
+      */
+    size_t capacity() const { return m_Capacity; }
+
+  private:
+    static const size_t BLOCK_SIZE = 64*1024;
+
+    std::vector<std::unique_ptr<uint8_t[]>> m_Blocks;
+    uint8_t*                                m_At       = nullptr;
+    size_t                                  m_Left     = 0;
+    size_t                                  m_Capacity = 0;
+  };
+
+  /**
+   * @brief Vob of an ArenaWorldData. Only the properties all vobs share are kept. Everything specific to
+   *        a class (items, mobs, triggers, lights, sounds, ...) is dropped. ZenParser::readVob() reads it
+   *        from the file the world was parsed from, into a regular zCVobData with its own allocations.
+   *        Vobs rejected by the vob-filter keep an identity worldMatrix.
+   */
+  struct ArenaVobData
+  {
+    size_t               offset      = 0;  // Start of the vob-chunk in the file
+    ZenParser::ZenClass  classId     = ZenParser::zUnknown;
+    zCVobData::EVobType  vobType     = zCVobData::VT_Unknown;
+    uint32_t             vobObjectID = uint32_t(-1);
+
+    // Vobs are stored depth-first: the first child follows its parent, the next one follows the subtree of
+    // the one before
+    uint32_t             parent      = uint32_t(-1);
+    uint32_t             numChildren = 0;
+    uint32_t             subtreeSize = 1;  // Number of vobs in this subtree, including this one
+
+    std::string_view     vobName;
+    std::string_view     visual;
+    std::string_view     presetName;
+    ZMath::float3        bbox[2]     = {};
+    ZMath::float3        position    = {};
+    ZMath::Matrix        worldMatrix = ZMath::Matrix::CreateIdentity();
+    bool                 showVisual  = false;
+    bool                 cdStatic    = false;
+    bool                 cdDyn       = false;
+    bool                 staticVob   = false;
+  };
+
+  struct ArenaWaypointData
+  {
+    std::string_view wpName;
+    int32_t          waterDepth = 0;
+    bool             underWater = false;
+    ZMath::float3    position   = {};
+    ZMath::float3    direction  = {};
+  };
+
+  /**
+   * @brief Flat form of oCWorldData, see ZenParser::readWorld(ArenaWorldData&, FileVersion). All strings
+   *        live in the arena, so parsing and destroying a world costs only a handful of allocations.
+   *        It isn't a complete world: vobs only have their common properties (see ArenaVobData), the
+   *        zen has to stay around to read the rest. Use oCWorldData when all of it is needed anyway.
+   */
+  struct ArenaWorldData
+  {
+    WorldArena                             arena;
+    std::vector<ArenaVobData>              vobs;
+    size_t                                 numRootVobs   = 0;
+    uint32_t                               waynetVersion = 0;
+    std::vector<ArenaWaypointData>         waypoints;
+    std::vector<std::pair<size_t, size_t>> edges;
+    zCBspTreeData                          bspTree = {};
+  };
+}  // namespace ZenLoad
@@ -0,0 +1,774 @@
+#include "worldCache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+#include "worldArena.h"
+#include "utils/logger.h"
+#include "vdfs/mappedFile.h"
+
+using namespace ZenLoad;
+
+namespace internal
+{
+  static const char     CACHE_MAGIC[8] = {'Z','L','W','O','R','L','D','C'};
+  static const uint32_t CACHE_VERSION  = 2;
+
+  // Sections start at multiples of this, so the engine-types in them can be used straight from the mapping
+  static const uint64_t SECTION_ALIGN  = 16;
+
+  enum Section : uint32_t
+  {
+    S_Vobs,
+    S_Waypoints,
+    S_Edges,
+    S_BspNodes,
+    S_LeafIndices,
+    S_TreePolyIndices,
+    S_PortalPolyIndices,
+    S_Sectors,
+    S_Portals,
+    S_SectorIndices,     // bspNodeIndices and portalPolygonIndices of all sectors
+    S_Triangles,
+    S_Vertices,
+    S_Indices,
+    S_VerticesId,
+    S_SubMeshes,
+    S_LightmapIndices,   // triangleLightmapIndices of all sub-meshes
+    S_Clusters,
+    S_Strings,
+    NUM_SECTIONS
+  };
+
+#pragma pack(push, 1)
+  struct CacheString
+  {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  struct CacheSection
+  {
+    uint64_t offset;
+    uint64_t count;
+    uint32_t elemSize;  // Differs if the file was made by a build with another layout of the engine-types
+    uint32_t reserved;
+  };
+
+  struct CacheHeader
+  {
+    char          magic[8];
+    uint32_t      version;
+    uint32_t      reserved;
+    uint64_t      sourceHash;
+    uint64_t      numRootVobs;
+    uint32_t      waynetVersion;
+    uint32_t      bspMode;
+    uint32_t      bspVersion;
+    uint32_t      isUsingAlphaTest;
+    ZMath::float3 bbox[2];
+    CacheSection  sections[NUM_SECTIONS];
+  };
+
+  struct CacheVob
+  {
+    uint64_t      offset;
+    uint32_t      classId;
+    uint32_t      vobType;
+    uint32_t      vobObjectID;
+    uint32_t      parent;
+    uint32_t      numChildren;
+    uint32_t      subtreeSize;
+    CacheString   vobName;
+    CacheString   visual;
+    CacheString   presetName;
+    ZMath::float3 bbox[2];
+    ZMath::float3 position;
+    ZMath::Matrix worldMatrix;
+    uint8_t       showVisual;
+    uint8_t       cdStatic;
+    uint8_t       cdDyn;
+    uint8_t       staticVob;
+  };
+
+  struct CacheWaypoint
+  {
+    CacheString   wpName;
+    int32_t       waterDepth;
+    uint32_t      underWater;
+    ZMath::float3 position;
+    ZMath::float3 direction;
+  };
+
+  struct CacheEdge
+  {
+    uint32_t wp1;
+    uint32_t wp2;
+  };
+
+  struct CacheSector
+  {
+    CacheString name;
+    uint32_t    firstNodeIndex;
+    uint32_t    numNodeIndices;
+    uint32_t    firstPortalPolyIndex;
+    uint32_t    numPortalPolyIndices;
+  };
+
+  struct CachePortal
+  {
+    CacheString frontSectorName;
+    CacheString backSectorName;
+    uint32_t    frontSectorIndex;
+    uint32_t    backSectorIndex;
+  };
+
+  struct CacheSubMesh
+  {
+    uint64_t      indexOffset;
+    uint64_t      indexSize;
+    uint32_t      firstLightmapIndex;
+    uint32_t      numLightmapIndices;
+    uint32_t      firstCluster;
+    uint32_t      numClusters;
+
+    CacheString   matName;
+    CacheString   texture;
+    CacheString   texScale;
+    CacheString   texAniMapDir;
+    CacheString   detailObject;
+    uint32_t      color;
+    float         smoothAngle;
+    float         texAniFPS;
+    float         detailTextureScale;
+    float         environmentalMappingStrength;
+    float         waveMaxAmplitude;
+    float         waveGridSize;
+    ZMath::float2 defaultMapping;
+    uint8_t       matGroup;
+    uint8_t       texAniMapMode;
+    uint8_t       noCollDet;
+    uint8_t       noLighmap;
+    uint8_t       loadDontCollapse;
+    uint8_t       forceOccluder;
+    uint8_t       environmentMapping;
+    uint8_t       waveMode;
+    uint8_t       waveSpeed;
+    uint8_t       ignoreSun;
+    uint8_t       alphaFunc;
+    uint8_t       reserved;
+  };
+#pragma pack(pop)
+
+  static_assert(std::is_trivially_copyable<WorldTriangle>::value, "stored as it is");
+  static_assert(std::is_trivially_copyable<WorldVertex>::value,   "stored as it is");
+  static_assert(std::is_trivially_copyable<zCBspNode>::value,     "stored as it is");
+  static_assert(std::is_trivially_copyable<PackedMesh::Cluster>::value, "stored as it is");
+
+  static const uint32_t ELEM_SIZE[NUM_SECTIONS] = {
+    sizeof(CacheVob),
+    sizeof(CacheWaypoint),
+    sizeof(CacheEdge),
+    sizeof(zCBspNode),
+    sizeof(uint32_t),
+    sizeof(uint32_t),
+    sizeof(uint32_t),
+    sizeof(CacheSector),
+    sizeof(CachePortal),
+    sizeof(uint32_t),
+    sizeof(WorldTriangle),
+    sizeof(WorldVertex),
+    sizeof(uint32_t),
+    sizeof(uint32_t),
+    sizeof(CacheSubMesh),
+    sizeof(int16_t),
+    sizeof(PackedMesh::Cluster),
+    sizeof(char),
+  };
+
+  static CacheHeader header(const VDFS::MappedFile& map) {
+    CacheHeader h = {};
+    std::memcpy(&h, map.data(), sizeof(h));
+    return h;
+    }
+
+  /**
+   * @brief Collects the sections of a cache-file, so the offsets are known before anything is written
+   */
+  class Writer
+  {
+  public:
+    CacheString str(const std::string_view& s) {
+      CacheString ret = {uint32_t(m_Strings.size()), uint32_t(s.size())};
+      m_Strings.append(s.data(), s.size());
+      return ret;
+      }
+
+    template<class T>
+    void set(Section id, const T* data, size_t count) {
+      m_Sections[id] = {data, count};
+      }
+
+    template<class T>
+    void set(Section id, const std::vector<T>& v) {
+      set(id, v.data(), v.size());
+      }
+
+    bool write(std::ostream& out, CacheHeader& h) {
+      set(S_Strings, m_Strings.data(), m_Strings.size());
+
+      uint64_t at = sizeof(CacheHeader);
+      for(uint32_t i=0; i<NUM_SECTIONS; ++i) {
+        at = (at+SECTION_ALIGN-1)/SECTION_ALIGN*SECTION_ALIGN;
+        h.sections[i].offset   = at;
+        h.sections[i].count    = m_Sections[i].count;
+        h.sections[i].elemSize = ELEM_SIZE[i];
+        at += m_Sections[i].count*ELEM_SIZE[i];
+        }
+
+      static const char zeros[SECTION_ALIGN] = {};
+      uint64_t written = sizeof(CacheHeader);
+      out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+      for(uint32_t i=0; i<NUM_SECTIONS; ++i) {
+        out.write(zeros, std::streamsize(h.sections[i].offset-written));
+        out.write(reinterpret_cast<const char*>(m_Sections[i].data), std::streamsize(m_Sections[i].count*ELEM_SIZE[i]));
+        written = h.sections[i].offset + m_Sections[i].count*ELEM_SIZE[i];
+        }
+      return out.good();
+      }
+
+  private:
+    struct Data
+    {
+      const void* data  = nullptr;
+      uint64_t    count = 0;
+    };
+
+    Data        m_Sections[NUM_SECTIONS];
+    std::string m_Strings;
+  };
+
+  static bool inRange(uint64_t first, uint64_t count, uint64_t size) {
+    return first<=size && count<=size-first;
+    }
+
+  /**
+   * @brief Copies engine-types that are stored as they are member by member into zeroed memory, so their padding
+   *        doesn't end up in the file and the same world always gives the same cache-file
+   */
+  template<class T, class Fn>
+  static std::vector<T> withoutPadding(const std::vector<T>& src, Fn copy) {
+    std::vector<T> ret(src.size());
+    std::memset(static_cast<void*>(ret.data()), 0, ret.size()*sizeof(T));
+    for(size_t i=0; i<src.size(); ++i)
+      copy(ret[i], src[i]);
+    return ret;
+    }
+
+  // A member added to one of these types would be lost by its helper, while ELEM_SIZE still accepts old files
+  static_assert(sizeof(PolyFlags)==4, "update copyFlags() and bump CACHE_VERSION");
+  static void copyFlags(PolyFlags& dst, const PolyFlags& src) {
+    dst.portalPoly          = src.portalPoly;
+    dst.occluder            = src.occluder;
+    dst.sectorPoly          = src.sectorPoly;
+    dst.mustRelight         = src.mustRelight;
+    dst.portalIndoorOutdoor = src.portalIndoorOutdoor;
+    dst.ghostOccluder       = src.ghostOccluder;
+    dst.noDynLightNear      = src.noDynLightNear;
+    dst.sectorIndex         = src.sectorIndex;
+    dst.lodFlag             = src.lodFlag;
+    dst.normalMainAxis      = src.normalMainAxis;
+    }
+
+  static_assert(sizeof(WorldTriangle)==120, "update copyTriangle() and bump CACHE_VERSION");
+  static void copyTriangle(WorldTriangle& dst, const WorldTriangle& src) {
+    copyFlags(dst.flags, src.flags);
+    dst.lightmapIndex = src.lightmapIndex;
+    for(size_t i=0; i<3; ++i)
+      dst.vertices[i] = src.vertices[i];
+    dst.submeshIndex  = src.submeshIndex;
+    }
+
+  static_assert(sizeof(zCBspNode)==(sizeof(size_t)==8 ? 88 : 76), "update copyNode() and bump CACHE_VERSION");
+  static void copyNode(zCBspNode& dst, const zCBspNode& src) {
+    dst.plane         = src.plane;
+    dst.front         = src.front;
+    dst.back          = src.back;
+    dst.parent        = src.parent;
+    dst.bbox3dMin     = src.bbox3dMin;
+    dst.bbox3dMax     = src.bbox3dMax;
+    dst.treePolyIndex = src.treePolyIndex;
+    dst.numPolys      = src.numPolys;
+    dst.lodFlag       = src.lodFlag;
+    dst.light         = src.light;
+    }
+
+  static_assert(sizeof(PackedMesh::Cluster)==(sizeof(size_t)==8 ? 88 : 76), "update copyCluster() and bump CACHE_VERSION");
+  static void copyCluster(PackedMesh::Cluster& dst, const PackedMesh::Cluster& src) {
+    dst.indexOffset  = src.indexOffset;
+    dst.indexSize    = src.indexSize;
+    dst.bbox[0]      = src.bbox[0];
+    dst.bbox[1]      = src.bbox[1];
+    dst.sphereCenter = src.sphereCenter;
+    dst.sphereRadius = src.sphereRadius;
+    dst.coneApex     = src.coneApex;
+    dst.coneAxis     = src.coneAxis;
+    dst.coneCutoff   = src.coneCutoff;
+    }
+}  // namespace internal
+
+WorldCache::WorldCache() {
+  }
+
+WorldCache::~WorldCache() {
+  }
+
+uint64_t WorldCache::hashSource(const uint8_t* data, size_t size) {
+  // FNV-1a, 64 bit. Never 0, like the hashes of the FileIndex.
+  uint64_t h = 14695981039346656037ull;
+  for(size_t i=0; i<size; ++i) {
+    h ^= data[i];
+    h *= 1099511628211ull;
+    }
+  return h!=0 ? h : 1;
+  }
+
+bool WorldCache::write(const std::string& path, uint64_t sourceHash, const ArenaWorldData& world, const PackedMesh& mesh) {
+  using namespace internal;
+  Writer w;
+
+  std::vector<CacheVob> vobs(world.vobs.size());
+  for(size_t i=0; i<vobs.size(); ++i) {
+    const ArenaVobData& v = world.vobs[i];
+    CacheVob&           c = vobs[i];
+    c.offset      = v.offset;
+    c.classId     = uint32_t(v.classId);
+    c.vobType     = uint32_t(v.vobType);
+    c.vobObjectID = v.vobObjectID;
+    c.parent      = v.parent;
+    c.numChildren = v.numChildren;
+    c.subtreeSize = v.subtreeSize;
+    c.vobName     = w.str(v.vobName);
+    c.visual      = w.str(v.visual);
+    c.presetName  = w.str(v.presetName);
+    c.bbox[0]     = v.bbox[0];
+    c.bbox[1]     = v.bbox[1];
+    c.position    = v.position;
+    c.worldMatrix = v.worldMatrix;
+    c.showVisual  = v.showVisual;
+    c.cdStatic    = v.cdStatic;
+    c.cdDyn       = v.cdDyn;
+    c.staticVob   = v.staticVob;
+    }
+
+  std::vector<CacheWaypoint> waypoints(world.waypoints.size());
+  for(size_t i=0; i<waypoints.size(); ++i) {
+    const ArenaWaypointData& wp = world.waypoints[i];
+    waypoints[i].wpName     = w.str(wp.wpName);
+    waypoints[i].waterDepth = wp.waterDepth;
+    waypoints[i].underWater = wp.underWater;
+    waypoints[i].position   = wp.position;
+    waypoints[i].direction  = wp.direction;
+    }
+
+  std::vector<CacheEdge> edges(world.edges.size());
+  for(size_t i=0; i<edges.size(); ++i)
+    edges[i] = {uint32_t(world.edges[i].first), uint32_t(world.edges[i].second)};
+
+  const zCBspTreeData&     bsp = world.bspTree;
+  std::vector<uint32_t>    sectorIndices;
+  std::vector<CacheSector> sectors(bsp.sectors.size());
+  for(size_t i=0; i<sectors.size(); ++i) {
+    const zCSector& s = bsp.sectors[i];
+    sectors[i].name                 = w.str(s.name);
+    sectors[i].firstNodeIndex       = uint32_t(sectorIndices.size());
+    sectors[i].numNodeIndices       = uint32_t(s.bspNodeIndices.size());
+    sectorIndices.insert(sectorIndices.end(), s.bspNodeIndices.begin(), s.bspNodeIndices.end());
+    sectors[i].firstPortalPolyIndex = uint32_t(sectorIndices.size());
+    sectors[i].numPortalPolyIndices = uint32_t(s.portalPolygonIndices.size());
+    sectorIndices.insert(sectorIndices.end(), s.portalPolygonIndices.begin(), s.portalPolygonIndices.end());
+    }
+
+  std::vector<CachePortal> portals(bsp.portals.size());
+  for(size_t i=0; i<portals.size(); ++i) {
+    const zCPortal& p = bsp.portals[i];
+    portals[i].frontSectorName  = w.str(p.frontSectorName);
+    portals[i].backSectorName   = w.str(p.backSectorName);
+    portals[i].frontSectorIndex = p.frontSectorIndex;
+    portals[i].backSectorIndex  = p.backSectorIndex;
+    }
+
+  std::vector<int16_t>      lightmapIndices;
+  std::vector<CacheSubMesh> subMeshes(mesh.subMeshes.size());
+  for(size_t i=0; i<subMeshes.size(); ++i) {
+    const PackedMesh::SubMesh& s = mesh.subMeshes[i];
+    const zCMaterialData&      m = s.material;
+    CacheSubMesh&              c = subMeshes[i];
+    c.indexOffset                  = s.indexOffset;
+    c.indexSize                    = s.indexSize;
+    c.firstLightmapIndex           = uint32_t(lightmapIndices.size());
+    c.numLightmapIndices           = uint32_t(s.triangleLightmapIndices.size());
+    lightmapIndices.insert(lightmapIndices.end(), s.triangleLightmapIndices.begin(), s.triangleLightmapIndices.end());
+    c.firstCluster                 = uint32_t(s.clusterOffset);
+    c.numClusters                  = uint32_t(s.clusterCount);
+
+    c.matName                      = w.str(m.matName);
+    c.texture                      = w.str(m.texture);
+    c.texScale                     = w.str(m.texScale);
+    c.texAniMapDir                 = w.str(m.texAniMapDir);
+    c.detailObject                 = w.str(m.detailObject);
+    c.color                        = m.color;
+    c.smoothAngle                  = m.smoothAngle;
+    c.texAniFPS                    = m.texAniFPS;
+    c.detailTextureScale           = m.detailTextureScale;
+    c.environmentalMappingStrength = m.environmentalMappingStrength;
+    c.waveMaxAmplitude             = m.waveMaxAmplitude;
+    c.waveGridSize                 = m.waveGridSize;
+    c.defaultMapping               = m.defaultMapping;
+    c.matGroup                     = m.matGroup;
+    c.texAniMapMode                = m.texAniMapMode;
+    c.noCollDet                    = m.noCollDet;
+    c.noLighmap                    = m.noLighmap;
+    c.loadDontCollapse             = m.loadDontCollapse;
+    c.forceOccluder                = m.forceOccluder;
+    c.environmentMapping           = m.environmentMapping;
+    c.waveMode                     = m.waveMode;
+    c.waveSpeed                    = m.waveSpeed;
+    c.ignoreSun                    = m.ignoreSun;
+    c.alphaFunc                    = m.alphaFunc;
+    }
+
+  const std::vector<zCBspNode>           nodes     = withoutPadding(bsp.nodes,      copyNode);
+  const std::vector<WorldTriangle>       triangles = withoutPadding(mesh.triangles, copyTriangle);
+  const std::vector<PackedMesh::Cluster> clusters  = withoutPadding(mesh.clusters,  copyCluster);
+
+  w.set(S_Vobs,              vobs);
+  w.set(S_Waypoints,         waypoints);
+  w.set(S_Edges,             edges);
+  w.set(S_BspNodes,          nodes);
+  w.set(S_LeafIndices,       bsp.leafIndices);
+  w.set(S_TreePolyIndices,   bsp.treePolyIndices);
+  w.set(S_PortalPolyIndices, bsp.portalPolyIndices);
+  w.set(S_Sectors,           sectors);
+  w.set(S_Portals,           portals);
+  w.set(S_SectorIndices,     sectorIndices);
+  w.set(S_Triangles,         triangles);
+  w.set(S_Vertices,          mesh.vertices);
+  w.set(S_Indices,           mesh.indices);
+  w.set(S_VerticesId,        mesh.verticesId);
+  w.set(S_SubMeshes,         subMeshes);
+  w.set(S_LightmapIndices,   lightmapIndices);
+  w.set(S_Clusters,          clusters);
+
+  CacheHeader h = {};
+  std::memcpy(h.magic, CACHE_MAGIC, sizeof(h.magic));
+  h.version          = CACHE_VERSION;
+  h.sourceHash       = sourceHash;
+  h.numRootVobs      = world.numRootVobs;
+  h.waynetVersion    = world.waynetVersion;
+  h.bspMode          = uint32_t(bsp.mode);
+  h.bspVersion       = bsp.version;
+  h.isUsingAlphaTest = mesh.isUsingAlphaTest;
+  h.bbox[0]          = mesh.bbox[0];
+  h.bbox[1]          = mesh.bbox[1];
+
+  // Write to a temporary first, so a crash can't leave a broken cache behind
+  const std::string tmp = path + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if(!w.write(out, h)) {
+      LogWarn() << "Failed to write world cache " << tmp;
+      return false;
+      }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(std::filesystem::u8path(tmp), std::filesystem::u8path(path), ec);
+  if(ec) {
+    LogWarn() << "Failed to replace world cache " << path << ": " << ec.message();
+    std::filesystem::remove(std::filesystem::u8path(tmp), ec);
+    return false;
+    }
+  return true;
+  }
+
+bool WorldCache::open(const std::string& path, uint64_t sourceHash) {
+  using namespace internal;
+  close();
+
+  auto map = VDFS::MappedFile::open(path);
+  if(map==nullptr || map->size()<sizeof(CacheHeader))
+    return false;
+
+  const CacheHeader h = header(*map);
+  if(std::memcmp(h.magic, CACHE_MAGIC, sizeof(h.magic))!=0 || h.version!=CACHE_VERSION) {
+    LogInfo() << "Ignoring outdated world cache " << path;
+    return false;
+    }
+  if(h.sourceHash!=sourceHash) {
+    LogInfo() << "Ignoring world cache " << path << ", it was made from a different zen";
+    return false;
+    }
+
+  for(uint32_t i=0; i<NUM_SECTIONS; ++i) {
+    const CacheSection& s = h.sections[i];
+    if(s.elemSize!=ELEM_SIZE[i] || s.offset%SECTION_ALIGN!=0 ||
+       s.offset>map->size() || s.count>(map->size()-s.offset)/s.elemSize) {
+      LogInfo() << "Ignoring outdated world cache " << path;
+      return false;
+      }
+    }
+
+  // The views are handed out as they are, so the mesh has to hold together before anyone gets to see it
+  m_Map = std::move(map);
+  const auto vert = vertices();
+  const auto ind  = indices();
+  bool ok = true;
+  for(uint32_t i:ind)
+    ok &= i<vert.size;
+  for(const PackedMesh::Cluster& c:clusters())
+    ok &= inRange(c.indexOffset, c.indexSize, ind.size);
+  for(const CacheSubMesh& s:section<CacheSubMesh>(S_SubMeshes))
+    ok &= inRange(s.indexOffset, s.indexSize, ind.size);
+  if(!ok) {
+    LogError() << "Ignoring broken world cache " << path;
+    close();
+    return false;
+    }
+  return true;
+  }
+
+void WorldCache::close() {
+  m_Map.reset();
+  }
+
+template<class T>
+WorldCache::View<T> WorldCache::section(size_t id) const {
+  View<T> ret;
+  if(m_Map==nullptr)
+    return ret;
+  const internal::CacheHeader h = internal::header(*m_Map);
+  ret.data = reinterpret_cast<const T*>(m_Map->data() + h.sections[id].offset);
+  ret.size = size_t(h.sections[id].count);
+  return ret;
+  }
+
+WorldCache::View<WorldTriangle> WorldCache::triangles() const {
+  return section<WorldTriangle>(internal::S_Triangles);
+  }
+
+WorldCache::View<WorldVertex> WorldCache::vertices() const {
+  return section<WorldVertex>(internal::S_Vertices);
+  }
+
+WorldCache::View<uint32_t> WorldCache::indices() const {
+  return section<uint32_t>(internal::S_Indices);
+  }
+
+WorldCache::View<zCBspNode> WorldCache::bspNodes() const {
+  return section<zCBspNode>(internal::S_BspNodes);
+  }
+
+WorldCache::View<PackedMesh::Cluster> WorldCache::clusters() const {
+  return section<PackedMesh::Cluster>(internal::S_Clusters);
+  }
+
+bool WorldCache::readWorld(ArenaWorldData& world) const {
+  using namespace internal;
+  if(m_Map==nullptr)
+    return false;
+
+  const CacheHeader h       = header(*m_Map);
+  const auto        strings = section<char>(S_Strings);
+
+  // All strings go to the arena in one piece, the views point into that copy
+  const char* str = nullptr;
+  if(strings.size>0) {
+    char* dst = world.arena.allocate<char>(strings.size);
+    std::memcpy(dst, strings.data, strings.size);
+    str = dst;
+    }
+  bool ok = true;
+  auto view = [&](const CacheString& s) {
+    if(!inRange(s.offset, s.length, strings.size)) {
+      ok = false;
+      return std::string_view();
+      }
+    return std::string_view(str+s.offset, s.length);
+    };
+
+  const auto vobs = section<CacheVob>(S_Vobs);
+  world.numRootVobs = size_t(h.numRootVobs);
+  world.vobs.resize(vobs.size);
+  for(size_t i=0; i<vobs.size; ++i) {
+    const CacheVob& c = vobs.data[i];
+    ArenaVobData&   v = world.vobs[i];
+    v.offset      = size_t(c.offset);
+    v.classId     = ZenParser::ZenClass(c.classId);
+    v.vobType     = zCVobData::EVobType(c.vobType);
+    v.vobObjectID = c.vobObjectID;
+    v.parent      = c.parent;
+    v.numChildren = c.numChildren;
+    v.subtreeSize = c.subtreeSize;
+    v.vobName     = view(c.vobName);
+    v.visual      = view(c.visual);
+    v.presetName  = view(c.presetName);
+    v.bbox[0]     = c.bbox[0];
+    v.bbox[1]     = c.bbox[1];
+    v.position    = c.position;
+    v.worldMatrix = c.worldMatrix;
+    v.showVisual  = c.showVisual!=0;
+    v.cdStatic    = c.cdStatic!=0;
+    v.cdDyn       = c.cdDyn!=0;
+    v.staticVob   = c.staticVob!=0;
+    }
+
+  const auto waypoints = section<CacheWaypoint>(S_Waypoints);
+  world.waynetVersion = h.waynetVersion;
+  world.waypoints.resize(waypoints.size);
+  for(size_t i=0; i<waypoints.size; ++i) {
+    const CacheWaypoint& c  = waypoints.data[i];
+    ArenaWaypointData&   wp = world.waypoints[i];
+    wp.wpName     = view(c.wpName);
+    wp.waterDepth = c.waterDepth;
+    wp.underWater = c.underWater!=0;
+    wp.position   = c.position;
+    wp.direction  = c.direction;
+    }
+
+  const auto edges = section<CacheEdge>(S_Edges);
+  world.edges.resize(edges.size);
+  for(size_t i=0; i<edges.size; ++i) {
+    if(edges.data[i].wp1>=waypoints.size || edges.data[i].wp2>=waypoints.size)
+      ok = false;
+    world.edges[i] = {edges.data[i].wp1, edges.data[i].wp2};
+    }
+
+  zCBspTreeData& bsp = world.bspTree;
+  const auto nodes             = section<zCBspNode>(S_BspNodes);
+  const auto leafIndices       = section<uint32_t>(S_LeafIndices);
+  const auto treePolyIndices   = section<uint32_t>(S_TreePolyIndices);
+  const auto portalPolyIndices = section<uint32_t>(S_PortalPolyIndices);
+  bsp.mode    = zCBspTreeData::TreeMode(h.bspMode);
+  bsp.version = h.bspVersion;
+  bsp.nodes            .assign(nodes.begin(),             nodes.end());
+  bsp.leafIndices      .assign(leafIndices.begin(),       leafIndices.end());
+  bsp.treePolyIndices  .assign(treePolyIndices.begin(),   treePolyIndices.end());
+  bsp.portalPolyIndices.assign(portalPolyIndices.begin(), portalPolyIndices.end());
+
+  const auto sectors       = section<CacheSector>(S_Sectors);
+  const auto sectorIndices = section<uint32_t>(S_SectorIndices);
+  bsp.sectors.resize(sectors.size);
+  for(size_t i=0; i<sectors.size; ++i) {
+    const CacheSector& c = sectors.data[i];
+    zCSector&          s = bsp.sectors[i];
+    s.name = std::string(view(c.name));
+    if(!inRange(c.firstNodeIndex, c.numNodeIndices, sectorIndices.size) ||
+       !inRange(c.firstPortalPolyIndex, c.numPortalPolyIndices, sectorIndices.size)) {
+      ok = false;
+      continue;
+      }
+    const uint32_t* first = sectorIndices.data+c.firstNodeIndex;
+    s.bspNodeIndices.assign(first, first+c.numNodeIndices);
+    first = sectorIndices.data+c.firstPortalPolyIndex;
+    s.portalPolygonIndices.assign(first, first+c.numPortalPolyIndices);
+    }
+
+  const auto portals = section<CachePortal>(S_Portals);
+  bsp.portals.resize(portals.size);
+  for(size_t i=0; i<portals.size; ++i) {
+    const CachePortal& c = portals.data[i];
+    zCPortal&          p = bsp.portals[i];
+    p.frontSectorName  = std::string(view(c.frontSectorName));
+    p.backSectorName   = std::string(view(c.backSectorName));
+    p.frontSectorIndex = c.frontSectorIndex;
+    p.backSectorIndex  = c.backSectorIndex;
+    }
+
+  if(!ok)
+    LogError() << "World cache is broken";
+  return ok;
+  }
+
+bool WorldCache::readMesh(PackedMesh& mesh) const {
+  using namespace internal;
+  if(m_Map==nullptr)
+    return false;
+
+  const CacheHeader h          = header(*m_Map);
+  const auto        strings    = section<char>(S_Strings);
+  const auto        verticesId = section<uint32_t>(S_VerticesId);
+  const auto        tri        = triangles();
+  const auto        vert       = vertices();
+  const auto        ind        = indices();
+  const auto        cl         = clusters();
+
+  mesh.triangles .assign(tri.begin(),        tri.end());
+  mesh.vertices  .assign(vert.begin(),       vert.end());
+  mesh.indices   .assign(ind.begin(),        ind.end());
+  mesh.verticesId.assign(verticesId.begin(), verticesId.end());
+  mesh.clusters  .assign(cl.begin(),         cl.end());
+  mesh.bbox[0]          = h.bbox[0];
+  mesh.bbox[1]          = h.bbox[1];
+  mesh.isUsingAlphaTest = h.isUsingAlphaTest!=0;
+
+  bool ok  = true;
+  auto str = [&](const CacheString& s, std::string& out) {
+    if(!inRange(s.offset, s.length, strings.size)) {
+      ok = false;
+      return;
+      }
+    out.assign(strings.data+s.offset, s.length);
+    };
+
+  const auto subMeshes       = section<CacheSubMesh>(S_SubMeshes);
+  const auto lightmapIndices = section<int16_t>(S_LightmapIndices);
+  mesh.subMeshes.resize(subMeshes.size);
+  for(size_t i=0; i<subMeshes.size; ++i) {
+    const CacheSubMesh&  c = subMeshes.data[i];
+    PackedMesh::SubMesh& s = mesh.subMeshes[i];
+    zCMaterialData&      m = s.material;
+    if(!inRange(c.indexOffset, c.indexSize, ind.size) ||
+       !inRange(c.firstLightmapIndex, c.numLightmapIndices, lightmapIndices.size) ||
+       !inRange(c.firstCluster, c.numClusters, cl.size)) {
+      ok = false;
+      continue;
+      }
+    s.indexOffset   = size_t(c.indexOffset);
+    s.indexSize     = size_t(c.indexSize);
+    s.clusterOffset = c.firstCluster;
+    s.clusterCount  = c.numClusters;
+    s.triangleLightmapIndices.assign(lightmapIndices.data+c.firstLightmapIndex,
+                                     lightmapIndices.data+c.firstLightmapIndex+c.numLightmapIndices);
+
+    str(c.matName,      m.matName);
+    str(c.texture,      m.texture);
+    str(c.texScale,     m.texScale);
+    str(c.texAniMapDir, m.texAniMapDir);
+    str(c.detailObject, m.detailObject);
+    m.color                        = c.color;
+    m.smoothAngle                  = c.smoothAngle;
+    m.texAniFPS                    = c.texAniFPS;
+    m.detailTextureScale           = c.detailTextureScale;
+    m.environmentalMappingStrength = c.environmentalMappingStrength;
+    m.waveMaxAmplitude             = c.waveMaxAmplitude;
+    m.waveGridSize                 = c.waveGridSize;
+    m.defaultMapping               = c.defaultMapping;
+    m.matGroup                     = c.matGroup;
+    m.texAniMapMode                = c.texAniMapMode;
+    m.noCollDet                    = c.noCollDet!=0;
+    m.noLighmap                    = c.noLighmap!=0;
+    m.loadDontCollapse             = c.loadDontCollapse;
+    m.forceOccluder                = c.forceOccluder;
+    m.environmentMapping           = c.environmentMapping;
+    m.waveMode                     = c.waveMode;
+    m.waveSpeed                    = c.waveSpeed;
+    m.ignoreSun                    = c.ignoreSun;
+    m.alphaFunc                    = c.alphaFunc;
+    }
+
+  if(!ok)
+    LogError() << "World cache is broken";
+  return ok;
+  }
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "zTypes.h"
+
+namespace VDFS
+{
+  class MappedFile;
+}
+
+namespace ZenLoad
+{
+  struct ArenaWorldData;
+
+  /**
+   * @brief Pre-baked world: vob-tree, waynet and bsp-tree of an ArenaWorldData together with the packed
+   *        world-mesh, in one flat file that is used straight from a read-only mapping. Everything is
+   *        addressed by offsets from the start of the file, nothing has to be parsed when loading.
+   *
+   *        The file is made once with write(), from a world parsed the usual way, and keyed by the hash of
+   *        the zen it was made from: open() refuses files made from a different zen or by a build with a
+   *        different memory layout, the world has to be parsed and the cache written again then.
+   *
+   *        Only what an ArenaWorldData holds is stored: the common vob-properties with the offset of each vob
+   *        in the zen, not the class-specific data of items, mobs, triggers, lights, sounds and so on. That
+   *        still needs the zen the cache was made from, see ZenParser::readVob().
+   */
+  class WorldCache
+  {
+  public:
+    /**
+      * @brief Range of elements inside the mapping, valid as long as the cache is open
+      */
+    template<class T>
+    struct View
+    {
+      const T* data = nullptr;
+      size_t   size = 0;
+
+      const T* begin() const { return data; }
+      const T* end()   const { return data+size; }
+    };
+
+    WorldCache();
+    WorldCache(WorldCache&)=delete;
+    WorldCache(WorldCache&&)=delete;
+    ~WorldCache();
+    WorldCache& operator=(WorldCache&)=delete;
+    WorldCache& operator=(WorldCache&&)=delete;
+
+    /**
+      * @brief Hash identifying the zen a cache was made from. Same as VDFS::FileIndex::getContentHash(),
+      *        which keeps it around, so files from a FileIndex don't have to be hashed again.
+      */
+    static uint64_t hashSource(const uint8_t* data, size_t size);
+
+    /**
+      * @brief Replaces the cache-file with the given world and world-mesh
+      * @param sourceHash hash of the zen the world was parsed from, see hashSource()
+      */
+    static bool write(const std::string& path, uint64_t sourceHash, const ArenaWorldData& world, const PackedMesh& mesh);
+
+    /**
+      * @brief Maps the given cache-file
+      * @return false if it doesn't exist, is broken or outdated, or was made from a zen with a different hash.
+      *         Indices past the vertices and clusters or sub-meshes past the indices count as broken.
+      */
+    bool open(const std::string& path, uint64_t sourceHash);
+    void close();
+    bool isOpen() const { return m_Map!=nullptr; }
+
+    /**
+      * @brief Fills the world from the cache. Arrays are copied in one go, strings end up in the arena.
+      * @return false if the cache is broken
+      */
+    bool readWorld(ArenaWorldData& world) const;
+
+    /**
+      * @brief Fills the world-mesh from the cache
+      * @return false if the cache is broken
+      */
+    bool readMesh(PackedMesh& mesh) const;
+
+    /**
+      * @brief Arrays of the world-mesh and bsp-tree without copying them, e.g. to upload them as they are.
+      *        Clusters are only there if MeshOptimizer::buildClusters() ran on the mesh before it was written.
+      */
+    View<WorldTriangle> triangles() const;
+    View<WorldVertex>   vertices()  const;
+    View<uint32_t>      indices()   const;
+    View<zCBspNode>     bspNodes()  const;
+    View<PackedMesh::Cluster> clusters() const;
+
+  private:
+    template<class T>
+    View<T> section(size_t id) const;
+
+    std::shared_ptr<VDFS::MappedFile> m_Map;
+  };
+}  // namespace ZenLoad
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include "parserImpl.h"
 #include "zenParser.h"
+#include "entryReader.h"
 #include "zenParserPropRead.h"
 #include <cassert>
 #include "zenload/zTypes.h"
@@ -29,25 +30,26 @@ zCCSLib::zCCSLib(ZenParser &parser, ZenLoad::ZenParser::FileVersion version) {
   readObjectData(parser,version);
   }
 
-static void readEventMessage(zCEventMessage& block, ZenParser& parser, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion version, zCCSAtomicBlock& /*parent*/) {
-  auto& rd = *parser.getImpl();
+template<class Rd>
+static void readEventMessage(zCEventMessage& block, ZenParser& /*parser*/, Rd& rd, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion version, zCCSAtomicBlock& /*parent*/) {
   if(version==ZenParser::FileVersion::Gothic1)
     rd.readEntry("subType", reinterpret_cast<uint8_t&>(block.subType));
   else
     rd.readEntry("subType", block.subType);
   }
 
-static void readScreenFx(zCEventScreenFX& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readEventMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readScreenFx(zCEventScreenFX& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readEventMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_ScreenFX;
-  auto& rd = *parser.getImpl();
   rd.readEntry("duration", block.duration);
   rd.readColor("color"   , block.color);
   rd.readEntry("fovDeg"  , block.fovDeg);
   }
 
-static void readNpcMessage(oCNpcMessage& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readEventMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readNpcMessage(oCNpcMessage& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readEventMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_Npc;
   if(parser.peekChar()=='['){
     ZenParser::ChunkHeader blkHdr={};
@@ -57,10 +59,10 @@ static void readNpcMessage(oCNpcMessage& block, ZenParser& parser, const ZenPars
     }
   }
 
-static void readCSCamera_EventMsg(zCCSCamera_EventMsg& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readEventMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readCSCamera_EventMsg(zCCSCamera_EventMsg& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readEventMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MsgCSCamera;
-  auto& rd = *parser.getImpl();
   switch (block.subType) {
     case (uint32_t)CamEventTypes::EV_CAM_SET_DURATION:
     case (uint32_t)CamEventTypes::EV_CAM_SET_TO_TIME:
@@ -81,47 +83,50 @@ static void readCSCamera_EventMsg(zCCSCamera_EventMsg& block, ZenParser& parser,
     }
   }
 
-static void readCSCamera_EventMsgActivate(zCCSCamera_EventMsgActivate& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readEventMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readCSCamera_EventMsgActivate(zCCSCamera_EventMsgActivate& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readEventMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MsgCSCameraActivate;
-  auto& rd = *parser.getImpl();
   rd.readEntry("refVobName", block.refVobName);
   }
   
-static void readEventCore(zCEventCore& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readEventMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventCore(zCEventCore& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readEventMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_Core;
-  auto& rd = *parser.getImpl();
   rd.readEntry("damage", block.damage, true);
   rd.readEntry("damageType", block.damageType, true);
   }
 
-static void readEventCommon(zCEventCommon& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readEventMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventCommon(zCEventCommon& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readEventMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_Common;
   }
 
-static void readEventMover(zCEventMover& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readEventMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMover(zCEventMover& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readEventMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_Mover;
   }
 
-static void readEventMsgAttack(oCMsgAttack& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readNpcMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMsgAttack(oCMsgAttack& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readNpcMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MsgAttack;
-  auto& rd = *parser.getImpl();
   rd.readEntry("combo", block.combo, true);
   }
 
-static void readEventMsgCutscene(zCEvMsgCutscene& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readEventMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMsgCutscene(zCEvMsgCutscene& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readEventMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MsgCutscene;
   }
 
-static void readEventMsgConversation(oCMsgConversation& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readNpcMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMsgConversation(oCMsgConversation& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readNpcMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MsgConversation;
-  auto& rd = *parser.getImpl();
   switch (block.subType) {
     case (uint32_t)ConversationEventTypes::EV_PLAYSOUND:
     case (uint32_t)ConversationEventTypes::EV_CUTSCENE:
@@ -164,24 +169,25 @@ static void readEventMsgConversation(oCMsgConversation& block, ZenParser& parser
       zCCSLib::addMessageByName(block.name.c_str(),std::move(block));
   }
 
-static void readEventMsgDamage(oCMsgDamage& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readNpcMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMsgDamage(oCMsgDamage& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readNpcMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MsgDamage;
   }
 
-static void readEventMsgMagic(oCMsgMagic& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readNpcMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMsgMagic(oCMsgMagic& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readNpcMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MsgMagic;
-  auto& rd = *parser.getImpl();
   rd.readEntry("what"        , block.what, true);
   rd.readEntry("level"       , block.level, true);
   rd.readEntry("removeSymbol", block.removeSymbol, true);
   }
 
-static void readEventMsgManipulate(oCMsgManipulate& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readNpcMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMsgManipulate(oCMsgManipulate& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readNpcMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MsgManipulate;
-  auto& rd = *parser.getImpl();
   switch (block.subType) {
     case (uint32_t)ManipulateEventTypes::EV_USEITEMTOSTATE:
     case (uint32_t)ManipulateEventTypes::EV_USEMOB: {
@@ -206,10 +212,10 @@ static void readEventMsgManipulate(oCMsgManipulate& block, ZenParser& parser, co
     }
   }
 
-static void readEventMsgMovement(oCMsgMovement& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readNpcMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMsgMovement(oCMsgMovement& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readNpcMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MsgMovement;
-  auto& rd = *parser.getImpl();
   switch (block.subType) {
     case (uint32_t)MovementEventTypes::EV_SETWALKMODE: {
       rd.readEntry("targetMode", block.targetMode, true); break;
@@ -245,145 +251,148 @@ static void readEventMsgMovement(oCMsgMovement& block, ZenParser& parser, const
     }
   }
 
-static void readEventMsgState(oCMsgState& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readNpcMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMsgState(oCMsgState& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readNpcMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_Npc;
   }
 
-static void readEventMsgUseItem(oCMsgUseItem& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readNpcMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMsgUseItem(oCMsgUseItem& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readNpcMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MsgUseItem;
   }
 
-static void readEventMsgWeapon(oCMsgWeapon& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readNpcMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMsgWeapon(oCMsgWeapon& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readNpcMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MsgWeapon;
-  auto& rd = *parser.getImpl();
   rd.readEntry("targetMode", block.targetMode, true);
   }
 
-static void readEventMusicController(zCEventMusicControler& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
-  readEventMessage(block,parser,header,version,parent);
+template<class Rd>
+static void readEventMusicController(zCEventMusicControler& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSAtomicBlock& parent) {
+  readEventMessage(block,parser,rd,header,version,parent);
   block.type = zCEventMessage::EventMsgType::MT_MusicController;
   }
 
-static void readAtomicBlock(zCCSAtomicBlock& block, ZenParser& parser, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion version, zCCSBlock& /*parent*/) {
+template<class Rd>
+static void readAtomicBlock(zCCSAtomicBlock& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion version, zCCSBlock& /*parent*/) {
   // assumed to only contain one event block
   ZenParser::ChunkHeader blkHdr;
   parser.readChunkStart(blkHdr);
-  auto& rd = *parser.getImpl();
   switch(blkHdr.classId) {
     case ZenParser::ZenClass::zCEventMessage: {
       zCEventMessage message;
-      readEventMessage(message,parser,blkHdr,version,block);
+      readEventMessage(message,parser,rd,blkHdr,version,block);
       block.command = message;
       break;
       }
     case ZenParser::ZenClass::zCEventScreenFX: {
       zCEventScreenFX screenFX;
-      readScreenFx(screenFX,parser,blkHdr,version,block);
+      readScreenFx(screenFX,parser,rd,blkHdr,version,block);
       block.command = screenFX;
       break;
       }
     case ZenParser::ZenClass::oCNpcMessage: {
       oCNpcMessage npc;
-      readNpcMessage(npc,parser,blkHdr,version,block);
+      readNpcMessage(npc,parser,rd,blkHdr,version,block);
       block.command = npc;
       break;
       }
     case ZenParser::ZenClass::zCCSCamera_EventMsg: {
       zCCSCamera_EventMsg cam;
-      readCSCamera_EventMsg(cam,parser,blkHdr,version,block);
+      readCSCamera_EventMsg(cam,parser,rd,blkHdr,version,block);
       block.command = cam;
       break;
       }
     case ZenParser::ZenClass::zCCSCamera_EventMsgActivate: {
       zCCSCamera_EventMsgActivate camActivate;
-      readCSCamera_EventMsgActivate(camActivate,parser,blkHdr,version,block);
+      readCSCamera_EventMsgActivate(camActivate,parser,rd,blkHdr,version,block);
       block.command = camActivate;
       break;
       }
     case ZenParser::ZenClass::zCEventCommon: {
       zCEventCommon common;
-      readEventCommon(common,parser,blkHdr,version,block);
+      readEventCommon(common,parser,rd,blkHdr,version,block);
       block.command = common;
       break;
       }
     case ZenParser::ZenClass::zCEventCore: {
       zCEventCore core;
-      readEventCore(core,parser,blkHdr,version,block);
+      readEventCore(core,parser,rd,blkHdr,version,block);
       block.command = core;
       break;
       }
     case ZenParser::ZenClass::zCMover: {
       zCEventMover mover;
-      readEventMover(mover,parser,blkHdr,version,block);
+      readEventMover(mover,parser,rd,blkHdr,version,block);
       block.command = mover;
       break;
       }
     case ZenParser::ZenClass::oCMsgAttack: {
       oCMsgAttack attack;
-      readEventMsgAttack(attack,parser,blkHdr,version,block);
+      readEventMsgAttack(attack,parser,rd,blkHdr,version,block);
       block.command = attack;
       break;
       }
     case ZenParser::ZenClass::ocMsgCutscene: {
       zCEvMsgCutscene cutscene;
-      readEventMsgCutscene(cutscene,parser,blkHdr,version,block);
+      readEventMsgCutscene(cutscene,parser,rd,blkHdr,version,block);
       block.command = cutscene;
       break;
       }
     case ZenParser::ZenClass::oCMsgConversation: {
       oCMsgConversation conversation;
-      readEventMsgConversation(conversation,parser,blkHdr,version,block);
+      readEventMsgConversation(conversation,parser,rd,blkHdr,version,block);
       block.command = conversation;
       break;
       }
     case ZenParser::ZenClass::oCMsgDamage: {
       oCMsgDamage damage;
-      readEventMsgDamage(damage,parser,blkHdr,version,block);
+      readEventMsgDamage(damage,parser,rd,blkHdr,version,block);
       block.command = damage;
       break;
       }
     case ZenParser::ZenClass::oCMsgMagic: {
       oCMsgMagic magic;
-      readEventMsgMagic(magic,parser,blkHdr,version,block);
+      readEventMsgMagic(magic,parser,rd,blkHdr,version,block);
       block.command = magic;
       break;
       }
     case ZenParser::ZenClass::oCMsgManipulate: {
       oCMsgManipulate manipulate;
-      readEventMsgManipulate(manipulate,parser,blkHdr,version,block);
+      readEventMsgManipulate(manipulate,parser,rd,blkHdr,version,block);
       block.command = manipulate;
       break;
       }
     case ZenParser::ZenClass::oCMsgMovement: {
       oCMsgMovement movement;
-      readEventMsgMovement(movement,parser,blkHdr,version,block);
+      readEventMsgMovement(movement,parser,rd,blkHdr,version,block);
       block.command = movement;
       break;
       }
     case ZenParser::ZenClass::oCMsgState: {
       oCMsgState state;
-      readEventMsgState(state,parser,blkHdr,version,block);
+      readEventMsgState(state,parser,rd,blkHdr,version,block);
       block.command = state;
       break;
       }
     case ZenParser::ZenClass::oCMsgUseItem: {
       oCMsgUseItem useItem;
-      readEventMsgUseItem(useItem,parser,blkHdr,version,block);
+      readEventMsgUseItem(useItem,parser,rd,blkHdr,version,block);
       block.command = useItem;
       break;
       }
     case ZenParser::ZenClass::oCMsgWeapon: {
       oCMsgWeapon weapon;
-      readEventMsgWeapon(weapon,parser,blkHdr,version,block);
+      readEventMsgWeapon(weapon,parser,rd,blkHdr,version,block);
       block.command = weapon;
       break;
       }
     case ZenParser::ZenClass::zCMusicControler: {
       zCEventMusicControler musicController;
-      readEventMusicController(musicController,parser,blkHdr,version,block);
+      readEventMusicController(musicController,parser,rd,blkHdr,version,block);
       block.command = musicController;
       break;
       }
@@ -396,29 +405,31 @@ static void readAtomicBlock(zCCSAtomicBlock& block, ZenParser& parser, const Zen
   parser.readChunkEnd();
   }
 
-static void readCSSyncBlock(zCCSSyncBlock& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSBlock& parent);
-static void readCSBlock(zCCSBlock& block, ZenParser& parser, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion version) {
+template<class Rd>
+static void readCSSyncBlock(zCCSSyncBlock& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSBlock& parent);
+template<class Rd>
+static void readCSBlock(zCCSBlock& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion version) {
   uint32_t numOfBlocks = 0;
-  ReadObjectProperties(parser,
+  ReadObjectProperties(rd,
   Prop("blockName"  , block.blockName),
   Prop("numOfBlocks", numOfBlocks));
   block.time.resize(numOfBlocks);
   for(size_t i=0;i<numOfBlocks;++i) {
-    ReadObjectProperties(parser,Prop((std::string("subBlock")+std::to_string(i)).c_str(),block.time[i]));
+    ReadObjectProperties(rd,Prop((std::string("subBlock")+std::to_string(i)).c_str(),block.time[i]));
     zCCSBlock csBlock;
     ZenParser::ChunkHeader blkHdr;
     parser.readChunkStart(blkHdr);
     switch(blkHdr.classId) {
       case ZenParser::ZenClass::zCCSAtomicBlock: {
         zCCSAtomicBlock atomic;
-        readAtomicBlock(atomic,parser,blkHdr,version,block);
+        readAtomicBlock(atomic,parser,rd,blkHdr,version,block);
         block.atomicBlocks.emplace_back(atomic);
         parser.readChunkEnd();
         break;
         }
       case ZenParser::ZenClass::zCCSSyncBlock: {
         zCCSSyncBlock syncBlock;
-        readCSSyncBlock(syncBlock,parser,blkHdr,version,block);
+        readCSSyncBlock(syncBlock,parser,rd,blkHdr,version,block);
         block.syncBlocks.emplace_back(syncBlock);
         parser.readChunkEnd();
         break;
@@ -430,20 +441,22 @@ static void readCSBlock(zCCSBlock& block, ZenParser& parser, const ZenParser::Ch
     }
   }
 
-static void readCSSyncBlock(zCCSSyncBlock& block, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSBlock& /*parent*/) {
-  readCSBlock(block,parser,header,version);
+template<class Rd>
+static void readCSSyncBlock(zCCSSyncBlock& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version, zCCSBlock& /*parent*/) {
+  readCSBlock(block,parser,rd,header,version);
   uint32_t numOfAss=0;
-  ReadObjectProperties(parser,Prop("numOfAss", numOfAss));
+  ReadObjectProperties(rd,Prop("numOfAss", numOfAss));
   block.roleAss.resize(numOfAss);
   for(size_t i=0;i<numOfAss;++i)
-    ReadObjectProperties(parser, Prop((std::string("roleAss")+std::to_string(i)).c_str(),block.roleAss[i]));
+    ReadObjectProperties(rd, Prop((std::string("roleAss")+std::to_string(i)).c_str(),block.roleAss[i]));
   }
 
-static void readCSProps(zCCSProps& props, ZenParser& parser, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion /*version*/, zCCSBlock& /*parent*/) {
+template<class Rd>
+static void readCSProps(zCCSProps& props, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion /*version*/, zCCSBlock& /*parent*/) {
   ZenParser::ChunkHeader roleHdr;
   parser.readChunkStart(roleHdr);
 
-  ReadObjectProperties(parser,
+  ReadObjectProperties(rd,
   Prop("globalCutscene"   , props.globalCutscene),
   Prop("csLoop"           , props.csLoop),
   Prop("hasToBeTriggerd"  , props.hasToBeTriggered),
@@ -458,11 +471,12 @@ static void readCSProps(zCCSProps& props, ZenParser& parser, const ZenParser::Ch
   parser.readChunkEnd();
   }
 
-static void readCSRole(zCCSRole& block, ZenParser& parser, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion /*version*/, zCCSBlock& /*parent*/) {
+template<class Rd>
+static void readCSRole(zCCSRole& block, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion /*version*/, zCCSBlock& /*parent*/) {
   ZenParser::ChunkHeader roleHdr;
   parser.readChunkStart(roleHdr);
 
-  ReadObjectProperties(parser,
+  ReadObjectProperties(rd,
   Prop("mustBeAlive", block.mustBeAlive),
   Prop("roleName"   , block.roleName),
   Prop("roleType"   , reinterpret_cast<uint32_t&>(block.roleType)));
@@ -475,24 +489,26 @@ static void readCSRole(zCCSRole& block, ZenParser& parser, const ZenParser::Chun
   parser.readChunkEnd();
   }
 
-static void readCSRoleVob(zCCSRoleVob& /*block*/, ZenParser& /*parser*/, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion /*version*/, zCCSBlock& /*parent*/) {
+template<class Rd>
+static void readCSRoleVob(zCCSRoleVob& /*block*/, ZenParser& /*parser*/, Rd& /*rd*/, const ZenParser::ChunkHeader &/*header*/, ZenParser::FileVersion /*version*/, zCCSBlock& /*parent*/) {
   }
 
-static void readCutsceneData(zCCutscene& cutscene, ZenParser& parser, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version) {
-  readCSBlock(cutscene,parser,header,version);
-  readCSProps(cutscene.props,parser,header,version,cutscene);
+template<class Rd>
+static void readCutsceneData(zCCutscene& cutscene, ZenParser& parser, Rd& rd, const ZenParser::ChunkHeader &header, ZenParser::FileVersion version) {
+  readCSBlock(cutscene,parser,rd,header,version);
+  readCSProps(cutscene.props,parser,rd,header,version,cutscene);
   uint32_t numOfRoles = 0;
-  parser.getImpl()->readEntry("numOfRoles", numOfRoles);
+  rd.readEntry("numOfRoles", numOfRoles);
   for(size_t i=0;i<numOfRoles;++i) {
     zCCSRole role;
-    readCSRole(role,parser,header,version,cutscene);
+    readCSRole(role,parser,rd,header,version,cutscene);
     cutscene.roles.emplace_back(role);
     }
   uint32_t numOfRoleVobs = 0;
-  parser.getImpl()->readEntry("numOfRoleVobs", numOfRoleVobs);
+  rd.readEntry("numOfRoleVobs", numOfRoleVobs);
   for(size_t i=0;i<numOfRoleVobs;++i) {
     zCCSRoleVob roleVob;
-    readCSRoleVob(roleVob,parser,header,version,cutscene);
+    readCSRoleVob(roleVob,parser,rd,header,version,cutscene);
     cutscene.roleVobs.emplace_back(roleVob);
     }
   ZenParser::ChunkHeader mainRoleHr;
@@ -504,39 +520,41 @@ static void readCutsceneData(zCCutscene& cutscene, ZenParser& parser, const ZenP
 void zCCSLib::readObjectData(ZenParser& parser, ZenLoad::ZenParser::FileVersion version) {
   parser.readHeader();
 
-  ZenParser::ChunkHeader libHeader;
-  parser.readChunkStart(libHeader);
+  withEntryReader(parser,[&](auto& rd) {
+    ZenParser::ChunkHeader libHeader;
+    parser.readChunkStart(libHeader);
 
-  if(libHeader.classId == ZenParser::zCCSBlock) {
-    readCutsceneData(cutsceneData,parser,libHeader,version);
-    return;
-    }
-  else if(libHeader.classId != ZenParser::zCCSLib)
-    throw std::runtime_error("Failed to read zCCSLib, neither zCCSLib nor zCCutscene");
+    if(libHeader.classId == ZenParser::zCCSBlock) {
+      readCutsceneData(cutsceneData,parser,rd,libHeader,version);
+      return;
+      }
+    else if(libHeader.classId != ZenParser::zCCSLib)
+      throw std::runtime_error("Failed to read zCCSLib, neither zCCSLib nor zCCutscene");
 
-  // FIXME: this clears data so the same stuff can be added again, implies a zCCSLib can only load one CSLib and possibly multiple cutscenes with collision for text strings
-  conversations.clear();
-  m_MessagesByName.clear();
+    // FIXME: this clears data so the same stuff can be added again, implies a zCCSLib can only load one CSLib and possibly multiple cutscenes with collision for text strings
+    conversations.clear();
+    m_MessagesByName.clear();
 
-  uint32_t NumOfItems=0;
-  parser.getImpl()->readEntry("NumOfItems", NumOfItems);
+    uint32_t NumOfItems=0;
+    rd.readEntry("NumOfItems", NumOfItems);
 
-  LogInfo() << "Reading " << NumOfItems << " blocks";
+    LogInfo() << "Reading " << NumOfItems << " blocks";
 
-  for (uint32_t i = 0; i < NumOfItems; i++) {
-    ZenParser::ChunkHeader blkHdr;
-    parser.readChunkStart(blkHdr);
+    for (uint32_t i = 0; i < NumOfItems; i++) {
+      ZenParser::ChunkHeader blkHdr;
+      parser.readChunkStart(blkHdr);
 
-    if(blkHdr.classId!=ZenParser::zCCSBlock) {
-      LogInfo() << "Unrecognized block " << blkHdr.name << " (" << blkHdr.classId << ") in CSLib";
-      parser.skipChunk();
-      continue;
-      }
+      if(blkHdr.classId!=ZenParser::zCCSBlock) {
+        LogInfo() << "Unrecognized block " << blkHdr.name << " (" << blkHdr.classId << ") in CSLib";
+        parser.skipChunk();
+        continue;
+        }
 
-    zCCSBlock blk;
-    readCSBlock(blk,parser,blkHdr,version);
-    parser.readChunkEnd();
-    }
+      zCCSBlock blk;
+      readCSBlock(blk,parser,rd,blkHdr,version);
+      parser.readChunkEnd();
+      }
+    });
   }
 
 void zCCSLib::addMessageByName(const std::string& name, oCMsgConversation&& msg) {
@@ -1,8 +1,11 @@
 #include "zCMesh.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
-#include <map>
+#include <memory>
 #include <string>
+#include <thread>
 
 #include "zCMaterial.h"
 #include "zTypes.h"
@@ -32,12 +35,164 @@ enum EVersion
   G2_2_6fix = 265
 };
 
+namespace internal
+{
+  /**
+   * @brief Calls fn(slice, first, last) for numThreads consecutive slices of [0,size), the first slice on
+   *        the calling thread. The slices only depend on numThreads and size.
+   */
+  template<class Fn>
+  static void parallelFor(size_t numThreads, size_t size, const Fn& fn) {
+    numThreads = std::max<size_t>(1, std::min(numThreads, size));
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads-1);
+    for(size_t t=1; t<numThreads; ++t)
+      threads.emplace_back([&fn,t,numThreads,size]() { fn(t, size*t/numThreads, size*(t+1)/numThreads); });
+    fn(0, 0, size/numThreads);
+    for(auto& t:threads)
+      t.join();
+    }
+
+  /**
+   * @brief Reads polygons of any mesh-version into the generic form. Keeps its buffers between polygons,
+   *        so one should be used for many of them.
+   */
+  class PolyDecoder
+  {
+  public:
+    PolyDecoder(uint16_t version, bool forceG132bitIndices)
+      :m_Version(version), m_ForceG132bitIndices(forceG132bitIndices) {
+      }
+
+    const polyData2<uint32_t, PolyFlags>& read(const uint8_t* data) {
+      if (m_Version == EVersion::G2_2_6fix) {
+        m_G2.read(data);
+        m_Poly.from(m_G2);
+        }
+      else if (m_ForceG132bitIndices) {
+        m_G1Wide.read(data);
+        m_Poly.from(m_G1Wide);
+        }
+      else {
+        m_G1.read(data);
+        m_Poly.from(m_G1);
+        }
+      return m_Poly;
+      }
+
+    /**
+     * @return number of triangles the polygon is split into, 0 if it is left out
+     */
+    static size_t numTriangles(const polyData2<uint32_t, PolyFlags>& p) {
+      // TODO: Store these somewhere else
+      // TODO: lodFlag isn't set to something useful in Gothic 1. Also the portal-flags aren't set? Investigate!
+      if (p.flags.ghostOccluder || p.flags.portalPoly || p.flags.portalIndoorOutdoor)
+        return 0;
+      return p.polyNumVertices >= 3 ? p.polyNumVertices - 2 : 0;
+      }
+
+  private:
+    uint16_t                                m_Version;
+    bool                                    m_ForceG132bitIndices;
+    polyData2<uint32_t, PolyFlags>          m_Poly;
+    polyData2<uint32_t, PolyFlags2_6fix>    m_G2;
+    polyData2<uint32_t, PolyFlags1_08k>     m_G1Wide;
+    polyData2<uint16_t, PolyFlags1_08k>     m_G1;
+  };
+
+  /**
+   * @brief Open-addressing set of the vertex/feature/lightmap combinations of an index-buffer, which several
+   *        threads may fill at once. Each slot holds the position in the index-buffer where its combination
+   *        is used first, so the content doesn't depend on the order of the insertions.
+   */
+  class WeldTable
+  {
+  public:
+    struct Key
+    {
+      uint64_t vertexFeature;
+      int64_t  lightmap;
+
+      bool operator==(const Key& other) const {
+        return vertexFeature==other.vertexFeature && lightmap==other.lightmap;
+        }
+    };
+
+    /**
+     * @param keys combination of each index, must stay alive as long as the table
+     */
+    WeldTable(const Key* keys, size_t numIndices)
+      :m_Keys(keys) {
+      size_t numSlots = 16;
+      while(numSlots<numIndices*2)
+        numSlots *= 2;
+      m_Slots.reset(new std::atomic<uint32_t>[numSlots]);
+      m_Mask = numSlots-1;
+      }
+
+    static Key key(uint32_t vertex, uint32_t feature, int16_t lightmap) {
+      return {uint64_t(vertex)<<32 | feature, lightmap};
+      }
+
+    void clear(size_t first, size_t last) {
+      for(size_t i=first; i<last; ++i)
+        m_Slots[i].store(EMPTY, std::memory_order_relaxed);
+      }
+
+    size_t numSlots() const { return m_Mask+1; }
+
+    void insert(uint32_t pos) {
+      const Key& k = m_Keys[pos];
+      for(size_t s=hash(k); ; s=(s+1)&m_Mask) {
+        uint32_t cur = m_Slots[s].load(std::memory_order_relaxed);
+        while(cur==EMPTY) {
+          if(m_Slots[s].compare_exchange_weak(cur, pos, std::memory_order_relaxed))
+            return;
+          }
+        if(!(m_Keys[cur]==k))
+          continue;
+        // Only positions of the same combination ever replace each other, keep the smallest
+        while(pos<cur && !m_Slots[s].compare_exchange_weak(cur, pos, std::memory_order_relaxed))
+          ;
+        return;
+        }
+      }
+
+    /**
+     * @return first position using the same combination as pos. Only valid after all insertions are done.
+     */
+    uint32_t find(uint32_t pos) const {
+      const Key& k = m_Keys[pos];
+      for(size_t s=hash(k); ; s=(s+1)&m_Mask) {
+        const uint32_t cur = m_Slots[s].load(std::memory_order_relaxed);
+        if(cur==EMPTY || m_Keys[cur]==k)
+          return cur;
+        }
+      }
+
+  private:
+    static const uint32_t EMPTY = uint32_t(-1);
+
+    size_t hash(const Key& k) const {
+      uint64_t h = k.vertexFeature ^ (uint64_t(k.lightmap)*0x9E3779B97F4A7C15ull);
+      h ^= h>>33;
+      h *= 0xff51afd7ed558ccdull;
+      h ^= h>>33;
+      return size_t(h)&m_Mask;
+      }
+
+    const Key*                               m_Keys;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_Slots;
+    size_t                                   m_Mask = 0;
+  };
+}  // namespace internal
+
 /**
 * @brief Loads the mesh from the given VDF-Archive
 */
 zCMesh::zCMesh(const std::string& fileName, VDFS::FileIndex& fileIndex) {
-  std::vector<uint8_t> data;
-  fileIndex.getFileData(fileName, data);
+  VDFS::FileView data;
+  fileIndex.getFileView(fileName, data);
 
   if (data.empty()) {
     LogInfo() << "Failed to find mesh " << fileName;
@@ -238,9 +393,6 @@ void zCMesh::readObjectData(ZenParser& parser, const std::vector<size_t>& skipPo
       break;
 
       case MSID_POLYLIST: {
-        // Current entry of the skip list. This is increased as we go.
-        size_t skipListEntry = 0;
-
         // Read number of polys
         auto const numPolys = parser.readBinaryDWord();
 
@@ -260,114 +412,115 @@ void zCMesh::readObjectData(ZenParser& parser, const std::vector<size_t>& skipPo
         if (forceG132bitIndices)
           indicesSize = sizeof(polyData2<uint32_t, PolyFlags1_08k>::IndexPacked);
 
-        // Iterate throuh every poly
-        m_Triangles.reserve(numPolys);
-        m_TriangleMaterialIndices.reserve(numPolys);
-        m_TriangleLightmapIndices.reserve(numPolys);
-
-        m_Indices.reserve(numPolys*3);
-        m_FeatureIndices.reserve(numPolys*3);
-
+        // Polygons differ in size, so finding where each one starts has to be done in order. The vertex-count
+        // is the last field of the fixed part. Only polygons in the skip-list (if any) are kept.
+        std::vector<const uint8_t*> polys;
+        polys.reserve(skipPolys.empty() ? numPolys : skipPolys.size());
+        size_t skipListEntry = 0;
         for(size_t i=0; i < numPolys; i++) {
-          // Convert to a generic version
-          polyData2<uint32_t, PolyFlags> p;
-          if (version == EVersion::G2_2_6fix) {
-            polyData2<uint32_t, PolyFlags2_6fix> d;
-            d.read(blockPtr);
-            p.from(d);
+          if (skipPolys.empty() || (skipListEntry < skipPolys.size() && skipPolys[skipListEntry] == i)) {
+            polys.push_back(blockPtr);
+            skipListEntry++;
             }
-          else {
-            if (forceG132bitIndices) {
-              polyData2<uint32_t, PolyFlags1_08k> d;
-              d.read(blockPtr);
-              p.from(d);
+          blockPtr += blockSize + indicesSize * blockPtr[blockSize-1];
+          }
+
+        // Count the triangles of each slice of polygons, turn the counts into output positions with a
+        // prefix-sum, then triangulate every slice into its own part of the arrays
+        const size_t        numSlices = std::max<size_t>(1, std::min(m_NumThreads, polys.size()));
+        std::vector<size_t> sliceStart(numSlices);
+        internal::parallelFor(m_NumThreads, polys.size(), [&](size_t slice, size_t first, size_t last) {
+          internal::PolyDecoder decoder(version, forceG132bitIndices);
+          size_t num = 0;
+          for(size_t i=first; i<last; ++i)
+            num += internal::PolyDecoder::numTriangles(decoder.read(polys[i]));
+          sliceStart[slice] = num;
+          });
+
+        size_t numTriangles = m_Triangles.size();
+        for(auto& s:sliceStart) {
+          const size_t num = s;
+          s             = numTriangles;
+          numTriangles += num;
+          }
+
+        m_Triangles.resize(numTriangles);
+        m_TriangleMaterialIndices.resize(numTriangles);
+        m_TriangleLightmapIndices.resize(numTriangles);
+        m_Indices.resize(numTriangles*3);
+        m_FeatureIndices.resize(numTriangles*3);
+
+        internal::parallelFor(m_NumThreads, polys.size(), [&](size_t slice, size_t first, size_t last) {
+          internal::PolyDecoder decoder(version, forceG132bitIndices);
+          size_t t = sliceStart[slice];
+          for(size_t i=first; i<last; ++i) {
+            auto& p = decoder.read(polys[i]);
+            if (internal::PolyDecoder::numTriangles(p) == 0)
+              continue;
+
+            if (p.polyNumVertices == 3) {
+              // Write indices directly to a vector
+              WorldVertex vx[3];
+              for (int v = 0; v < 3; v++) {
+                m_Indices[t*3+v]        = p.indices[v].VertexIndex;
+                m_FeatureIndices[t*3+v] = p.indices[v].FeatIndex;
+
+                // Gather vertex information
+                vx[v].Position = m_Vertices[p.indices[v].VertexIndex];
+                vx[v].Color = m_Features[p.indices[v].FeatIndex].lightStat;
+
+                vx[v].TexCoord = ZMath::float2(m_Features[p.indices[v].FeatIndex].uv[0],
+                                                m_Features[p.indices[v].FeatIndex].uv[1]);
+                vx[v].Normal = m_Features[p.indices[v].FeatIndex].vertNormal;
+                }
+
+              // Save material index for the written triangle
+              m_TriangleMaterialIndices[t] = p.materialIndex;
+
+              // Save lightmap-index
+              m_TriangleLightmapIndices[t] = p.lightmapIndex;
+
+              WorldTriangle& triangle = m_Triangles[t];
+              triangle.flags = p.flags;
+              memcpy((ZenLoad::WorldVertex*)triangle.vertices, (ZenLoad::WorldVertex*)vx, sizeof(vx));
+              t++;
               }
             else {
-              polyData2<uint16_t, PolyFlags1_08k> d;
-              d.read(blockPtr);
-              p.from(d);
-              }
-            }
-
-          if (skipPolys.empty() || (skipPolys[skipListEntry] == i)) {
-            // TODO: Store these somewhere else
-            // TODO: lodFlag isn't set to something useful in Gothic 1. Also the portal-flags aren't set? Investigate!
-            if (!p.flags.ghostOccluder && !p.flags.portalPoly &&
-                !p.flags.portalIndoorOutdoor) {
-              if (p.polyNumVertices != 0) {
-                if (p.polyNumVertices == 3) {
-                  // Write indices directly to a vector
-                  WorldVertex vx[3];
-                  for (int v = 0; v < 3; v++) {
-                    m_Indices.emplace_back(p.indices[v].VertexIndex);
-                    m_FeatureIndices.emplace_back(p.indices[v].FeatIndex);
-
-                    // Gather vertex information
-                    vx[v].Position = m_Vertices[p.indices[v].VertexIndex];
-                    vx[v].Color = m_Features[p.indices[v].FeatIndex].lightStat;
-
-                    vx[v].TexCoord = ZMath::float2(m_Features[p.indices[v].FeatIndex].uv[0],
-                                                    m_Features[p.indices[v].FeatIndex].uv[1]);
-                    vx[v].Normal = m_Features[p.indices[v].FeatIndex].vertNormal;
-                    }
-
-                  // Save material index for the written triangle
-                  m_TriangleMaterialIndices.push_back(p.materialIndex);
-
-                  // Save lightmap-index
-                  m_TriangleLightmapIndices.push_back(p.lightmapIndex);
-
-                  WorldTriangle triangle;
-                  triangle.flags = p.flags;
-                  memcpy((ZenLoad::WorldVertex*)triangle.vertices, (ZenLoad::WorldVertex*)vx, sizeof(vx));
-
-                  // Save triangle
-                  m_Triangles.push_back(triangle);
-                  }
-                else {
-                  // Triangulate a triangle-fan
-                  //for(unsigned int i = p.polyNumVertices - 2; i >= 1; i--)
-                  for (int idx = 1; idx < p.polyNumVertices - 1; idx++) {
-                    m_Indices.emplace_back(p.indices[0].VertexIndex);
-                    m_Indices.emplace_back(p.indices[idx].VertexIndex);
-                    m_Indices.emplace_back(p.indices[idx + 1].VertexIndex);
-
-                    m_FeatureIndices.emplace_back(p.indices[0].FeatIndex);
-                    m_FeatureIndices.emplace_back(p.indices[idx].FeatIndex);
-                    m_FeatureIndices.emplace_back(p.indices[idx + 1].FeatIndex);
-
-                    // Save material index for the written triangle
-                    m_TriangleMaterialIndices.push_back(p.materialIndex);
-
-                    // Save lightmap-index
-                    m_TriangleLightmapIndices.push_back(p.lightmapIndex);
-
-                    WorldTriangle triangle;
-                    triangle.flags = p.flags;
-                    uint32_t indices[] = {p.indices[0].VertexIndex, p.indices[idx].VertexIndex,
+              // Triangulate a triangle-fan
+              for (int idx = 1; idx < p.polyNumVertices - 1; idx++) {
+                uint32_t indices[] = {p.indices[0].VertexIndex, p.indices[idx].VertexIndex,
                                       p.indices[idx + 1].VertexIndex};
 
-                    // Gather vertex information
-                    for (int v = 0; v < 3; v++) {
-                      triangle.vertices[v].Position = m_Vertices[indices[v]];
-                      triangle.vertices[v].Color = m_Features[indices[v]].lightStat;
-                      triangle.vertices[v].TexCoord = ZMath::float2(m_Features[indices[v]].uv[0],
-                                                                    m_Features[indices[v]].uv[1]);
-                      triangle.vertices[v].Normal = m_Features[indices[v]].vertNormal;
-                      }
-
-                    // Start filling in the flags
-                    m_Triangles.push_back(triangle);
-                    }
+                m_Indices[t*3+0] = indices[0];
+                m_Indices[t*3+1] = indices[1];
+                m_Indices[t*3+2] = indices[2];
+
+                m_FeatureIndices[t*3+0] = p.indices[0].FeatIndex;
+                m_FeatureIndices[t*3+1] = p.indices[idx].FeatIndex;
+                m_FeatureIndices[t*3+2] = p.indices[idx + 1].FeatIndex;
+
+                // Save material index for the written triangle
+                m_TriangleMaterialIndices[t] = p.materialIndex;
+
+                // Save lightmap-index
+                m_TriangleLightmapIndices[t] = p.lightmapIndex;
+
+                WorldTriangle& triangle = m_Triangles[t];
+                triangle.flags = p.flags;
+
+                // Gather vertex information
+                for (int v = 0; v < 3; v++) {
+                  triangle.vertices[v].Position = m_Vertices[indices[v]];
+                  triangle.vertices[v].Color = m_Features[indices[v]].lightStat;
+                  triangle.vertices[v].TexCoord = ZMath::float2(m_Features[indices[v]].uv[0],
+                                                                m_Features[indices[v]].uv[1]);
+                  triangle.vertices[v].Normal = m_Features[indices[v]].vertNormal;
                   }
+                t++;
                 }
               }
-            skipListEntry++;
             }
-
-          // Goto next polygon using this weird shit
-          blockPtr += blockSize + indicesSize * p.polyNumVertices;
-          }
+          });
 
         if(parser.getSeek()!=chunkEnd)
           LogInfo() << "Skipping " << chunkEnd-parser.getSeek() << " bytes";
@@ -418,45 +571,69 @@ void zCMesh::packMesh(PackedMesh& mesh, float scale, bool removeDoubles) {
 	std::vector<uint32_t> newIndices;
 	newIndices.reserve(m_Indices.size());
 
-	// Map of vertex-indices and their used feature-indices to a vertex in "newVertices"
-	std::map<std::tuple<uint32_t, uint32_t, int16_t>, size_t> vfToNewVx;
-
-	// Map of the new indices and the old indices to the index-vector
-	//std::unordered_map<uint32_t, uint32_t> newToOldIdxIdx;
-
-	if(removeDoubles) {
-		// Get vertices
-		for(size_t i = 0, end = m_Indices.size(); i < end; i++) {
-			uint32_t featidx = m_FeatureIndices[i];
-			uint32_t vertidx = m_Indices[i];
-			int16_t lightmap = m_TriangleLightmapIndices[i / 3];
-
-			// Check if we already got this pair of vertex/feature
-			auto it = vfToNewVx.find(std::make_tuple(vertidx, featidx, lightmap));
-			if(it == vfToNewVx.end()) {
-				// Add new entry
-				vfToNewVx[std::make_tuple(vertidx, featidx, lightmap)] = newVertices.size();
-				WorldVertex vx;
-
-				// Extract vertex information
-				vx.Position = m_Vertices[vertidx] * scale;
-				vx.Color = m_Features[featidx].lightStat;
-				vx.TexCoord = ZMath::float2(m_Features[featidx].uv[0], m_Features[featidx].uv[1]);
-				vx.Normal = m_Features[featidx].vertNormal;
-
-				// Add index to this very vertex
-				newIndices.push_back((uint32_t)newVertices.size());
-
-				newVertices.push_back(vx);
-			  }
-			else {
-				// Simply put an index to the existing new vertex
-				newIndices.push_back((uint32_t)(*it).second);
-			  }
-
-			// Store what this new index was before
-			//newToOldIdxIdx[newIndices.end()-1] = i;
+  auto vertexAt = [&](size_t i) {
+    const zTMSH_FeatureChunk& feat = m_Features[m_FeatureIndices[i]];
+    WorldVertex vx;
+    vx.Position = m_Vertices[m_Indices[i]] * scale;
+    vx.Color    = feat.lightStat;
+    vx.TexCoord = ZMath::float2(feat.uv[0], feat.uv[1]);
+    vx.Normal   = feat.vertNormal;
+    return vx;
+    };
+
+  if(removeDoubles) {
+    // Every vertex/feature/lightmap combination becomes one vertex, numbered in order of first use:
+    // find the first use of the combination of each index, then number the first uses with a prefix-sum
+    const size_t numIndices = m_Indices.size();
+    const size_t numSlices  = std::max<size_t>(1, std::min(m_NumThreads, numIndices));
+    std::vector<internal::WeldTable::Key> keys(numIndices);
+    std::vector<uint32_t>                 firstUse(numIndices);
+    std::vector<size_t>                   numNew(numSlices);
+
+    internal::WeldTable table(keys.data(), numIndices);
+    internal::parallelFor(m_NumThreads, table.numSlots(), [&](size_t, size_t first, size_t last) {
+      table.clear(first, last);
+      });
+    internal::parallelFor(m_NumThreads, numIndices, [&](size_t, size_t first, size_t last) {
+      for(size_t i=first; i<last; ++i)
+        keys[i] = internal::WeldTable::key(m_Indices[i], m_FeatureIndices[i], m_TriangleLightmapIndices[i/3]);
+      });
+    internal::parallelFor(m_NumThreads, numIndices, [&](size_t, size_t first, size_t last) {
+      for(size_t i=first; i<last; ++i)
+        table.insert(uint32_t(i));
+      });
+    internal::parallelFor(m_NumThreads, numIndices, [&](size_t slice, size_t first, size_t last) {
+      size_t num = 0;
+      for(size_t i=first; i<last; ++i) {
+        firstUse[i] = table.find(uint32_t(i));
+        if(firstUse[i]==i)
+          ++num;
+        }
+      numNew[slice] = num;
+      });
+
+    size_t numVertices = 0;
+    for(auto& n:numNew) {
+      const size_t num = n;
+      n            = numVertices;
+      numVertices += num;
       }
+
+    newVertices.resize(numVertices);
+    newIndices.resize(numIndices);
+    internal::parallelFor(m_NumThreads, numIndices, [&](size_t slice, size_t first, size_t last) {
+      size_t id = numNew[slice];
+      for(size_t i=first; i<last; ++i) {
+        if(firstUse[i]!=i)
+          continue;
+        newVertices[id] = vertexAt(i);
+        newIndices[i]   = uint32_t(id++);
+        }
+      });
+    internal::parallelFor(m_NumThreads, numIndices, [&](size_t, size_t first, size_t last) {
+      for(size_t i=first; i<last; ++i)
+        newIndices[i] = newIndices[firstUse[i]];
+      });
     }
 	else {
 		// Just add them as triangles
@@ -510,6 +687,7 @@ void zCMesh::packMesh(PackedMesh& mesh, float scale, bool removeDoubles) {
     mesh.subMeshes[subMeshIdx].indexOffset=idxOffset;
     mesh.subMeshes[subMeshIdx].indexSize=idxSize;
     idxOffset+=idxSize;
+    subMeshIdx++;
     }
   mesh.indices=newIndices;
 
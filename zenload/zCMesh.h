@@ -123,6 +123,12 @@ class zCMesh  {
        */
     void packMesh(PackedMesh& mesh, float scale, bool removeDoubles);
 
+    /**
+       * @brief Runs the polygon-triangulation of readObjectData() and the vertex-welding of packMesh() on the
+       *        given number of threads. 0 or 1 do everything on the calling thread. The result is the same either way.
+       */
+    void setNumThreads(size_t numThreads) { m_NumThreads = numThreads; }
+
     /**
       @ brief returns the vector of vertex-positions
       */
@@ -258,5 +264,10 @@ class zCMesh  {
 		  * @brief Whether this mesh is using alphatest
 		  */
     uint8_t m_IsUsingAlphaTest;
+
+    /**
+       * @brief Threads to use, see setNumThreads()
+       */
+    size_t m_NumThreads = 0;
   };
 }  // namespace ZenLoad
@@ -32,8 +32,8 @@ const uint16_t MLID_MDH_END = 0xD120;
 * @brief Loads the lib from the given VDF-Archive
 */
 zCModelMeshLib::zCModelMeshLib(const std::string& fileName, const VDFS::FileIndex& fileIndex) {
-  std::vector<uint8_t> data;
-  fileIndex.getFileData(fileName, data);
+  VDFS::FileView data;
+  fileIndex.getFileView(fileName, data);
 
   if(data.empty())
     return;  // TODO: Throw an exception or something
@@ -75,8 +75,8 @@ std::vector<std::string> splitDecl(const std::string& _line)
 }
 
 zCModelPrototype::zCModelPrototype(const std::string& fileName, const VDFS::FileIndex& fileIndex) {
-  std::vector<uint8_t> data;
-  fileIndex.getFileData(fileName, data);
+  VDFS::FileView data;
+  fileIndex.getFileView(fileName, data);
 
   if (data.empty()) {
     LogInfo() << "Failed to find model prototype " << fileName;
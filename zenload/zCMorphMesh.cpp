@@ -20,8 +20,8 @@ enum MSID_CHUNK : uint16_t {
   };
 
 zCMorphMesh::zCMorphMesh(const std::string& fileName, const VDFS::FileIndex& fileIndex) {
-  std::vector<uint8_t> data;
-  fileIndex.getFileData(fileName, data);
+  VDFS::FileView data;
+  fileIndex.getFileView(fileName, data);
 
   if(data.empty()) {
     LogInfo() << "Failed to find morph mesh " << fileName;
@@ -43,8 +43,8 @@ struct MeshOffsetsSubMesh
 * @brief Loads the mesh from the given VDF-Archive
 */
 zCProgMeshProto::zCProgMeshProto(const std::string& fileName, const VDFS::FileIndex& fileIndex) {
-  std::vector<uint8_t> data;
-  fileIndex.getFileData(fileName, data);
+  VDFS::FileView data;
+  fileIndex.getFileView(fileName, data);
 
   if (data.empty()) {
     LogInfo() << "Failed to find progMesh " << fileName;
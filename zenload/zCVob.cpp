@@ -3,6 +3,7 @@
 #include <stdexcept>
 
 #include "zTypes.h"
+#include "entryReader.h"
 #include "zenParserPropRead.h"
 #include "parserImpl.h"
 #include "utils/logger.h"
@@ -45,9 +46,9 @@ struct packedVobData {
   };
 #pragma pack(pop)
 
-static void read_zCDecal(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  auto& d  = info.visualChunk.zCDecal;
-  auto& rd = *parser.getImpl();
+template<class Rd>
+static void read_zCDecal(zCVobData &info, ZenParser &/*parser*/, Rd& rd, ZenParser::FileVersion version) {
+  auto& d = info.visualChunk.zCDecal;
   rd.readEntry("name",           d.name);
   rd.readEntry("decalDim",       d.decalDim);
   rd.readEntry("decalOffset",    d.decalOffset);
@@ -60,20 +61,22 @@ static void read_zCDecal(zCVobData &info, ZenParser &parser, ZenParser::FileVers
     }
   }
 
-static void read_Visual(zCVobData &info, ZenParser &parser,
+template<class Rd>
+static void read_Visual(zCVobData &info, ZenParser &parser, Rd& rd,
                         const ZenParser::ChunkHeader &header, ZenParser::FileVersion version) {
   if(header.classId==ZenParser::zCProgMeshProto)
     return;
   if(header.classId==ZenParser::zCDecal)
-    return read_zCDecal(info,parser,version);
+    return read_zCDecal(info,parser,rd,version);
   }
 
-static void read_zCVob(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
+template<class Rd>
+static void read_zCVob(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
   info.vobType        = zCVobData::VT_zCVob;
   info.rotationMatrix = ZMath::Matrix::CreateIdentity();
 
   // Read how many vobs this one has as child
-  parser.getImpl()->readEntry("", info.pack);
+  rd.readEntry("", info.pack);
   bool hasRelevantVisualObject = true;
   bool hasAIObject             = true;
   bool hasEventManObject       = false;
@@ -81,7 +84,7 @@ static void read_zCVob(zCVobData &info, ZenParser &parser, ZenParser::FileVersio
   if(info.pack) {
     packedVobData  pd = {};
     packedBitField bitfield = {};
-    parser.getImpl()->readEntry("", &pd, sizeof(pd));
+    rd.readEntry("", &pd, sizeof(pd));
     std::memcpy(&bitfield,&pd.bits[0],3);
 
     info.bbox[0]               = pd.bbox3DWS[0];
@@ -103,19 +106,18 @@ static void read_zCVob(zCVobData &info, ZenParser &parser, ZenParser::FileVersio
     info.vobFarClipScale       = pd.vobFarClipZ;
 
     if(bitfield.hasPresetName)
-      parser.getImpl()->readEntry("", info.presetName);
+      rd.readEntry("", info.presetName);
 
     if(bitfield.hasVobName)
-      parser.getImpl()->readEntry("", info.vobName);
+      rd.readEntry("", info.vobName);
 
     if(bitfield.hasVisualName)
-      parser.getImpl()->readEntry("", info.visual);
+      rd.readEntry("", info.visual);
 
     hasRelevantVisualObject = bitfield.hasRelevantVisualObject;
     hasAIObject             = bitfield.hasAIObject;
     hasEventManObject       = bitfield.hasEventManObject;
     } else {
-    auto& rd = *parser.getImpl();
     rd.readEntry("presetName", info.presetName);
     rd.readEntry("",           &info.bbox, sizeof(info.bbox));
     rd.readEntry("",           &info.rotationMatrix3x3, sizeof(info.rotationMatrix3x3));
@@ -150,7 +152,7 @@ static void read_zCVob(zCVobData &info, ZenParser &parser, ZenParser::FileVersio
   if(hasRelevantVisualObject) {
     ZenParser::ChunkHeader hdr;
     parser.readChunkStart(hdr);
-    read_Visual(info,parser,hdr,version);
+    read_Visual(info,parser,rd,hdr,version);
     if(!parser.readChunkEnd())
       parser.skipChunk();
     }
@@ -168,8 +170,8 @@ static void read_zCVob(zCVobData &info, ZenParser &parser, ZenParser::FileVersio
     ZenParser::ChunkHeader tmph;
     if(parser.readChunkStart(tmph)) {
       zCEventManagerData emd;
-      parser.getImpl()->readEntry("cleared", emd.cleared);
-      parser.getImpl()->readEntry("active",  emd.active);
+      rd.readEntry("cleared", emd.cleared);
+      rd.readEntry("active",  emd.active);
       ZenParser::ChunkHeader emCutscene;
       if(parser.readChunkStart(emCutscene)) {
         // no data here
@@ -183,49 +185,53 @@ static void read_zCVob(zCVobData &info, ZenParser &parser, ZenParser::FileVersio
   info.worldMatrix = info.rotationMatrix3x3.toMatrix(info.position);
   }
 
-static void read_zCVobLevelCompo(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVobLevelCompo(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   info.vobType = zCVobData::VT_zCVobLevelCompo;
   }
 
-static void read_zCVob_oCItem(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCItem(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_oCItem;
   rd.readEntry("itemInstance", info.oCItem.instanceName);
   }
 
-static void read_zCVob_zCVobSpot(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCVobSpot(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   info.vobType = zCVobData::VT_zCVobSpot;
   }
 
-static void read_zCVob_zCVobStair(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCVobStair(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   info.vobType = zCVobData::VT_zCVobStair;
   }
 
-static void read_zCVob_zCVobStartpoint(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCVobStartpoint(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   info.vobType = zCVobData::VT_zCVobStartpoint;
   }
 
-static void read_zCMessageFilter(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCMessageFilter(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCMessageFilter;
   rd.readEntry("triggerTarget", info.zCMessageFilter.triggerTarget);
   rd.readEntry("onTrigger",     reinterpret_cast<uint32_t&>(info.zCMessageFilter.onTrigger));
   rd.readEntry("onUntrigger",   reinterpret_cast<uint32_t&>(info.zCMessageFilter.onUntrigger));
   }
 
-static void read_zCCodeMaster(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCCodeMaster(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   uint8_t     count=0;
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCCodeMaster;
   rd.readEntry("triggerTarget",        info.zCCodeMaster.triggerTarget);
   rd.readEntry("orderRelevant",        info.zCCodeMaster.orderRelevant);
@@ -244,10 +250,10 @@ static void read_zCCodeMaster(zCVobData &info, ZenParser &parser, ZenParser::Fil
     }
   }
 
-static void read_zCVob_zCTrigger(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCTrigger(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCTrigger;
   rd.readEntry("triggerTarget",     info.zCTrigger.triggerTarget);
   rd.readEntry("flags",             &info.zCTrigger.flags,       sizeof(info.zCTrigger.flags));
@@ -259,28 +265,28 @@ static void read_zCVob_zCTrigger(zCVobData &info, ZenParser &parser, ZenParser::
   rd.readEntry("fireDelaySec",      info.zCTrigger.fireDelaySec);
   }
 
-static void read_zCVob_zCTrigger_zCTriggerUntouch(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCTrigger_zCTriggerUntouch(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCTriggerUntouch;
   rd.readEntry("triggerTarget", info.zCTriggerUntouch.triggerTarget);
   }
 
-static void read_zCVob_zCTrigger_zCMoverController(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCTrigger_zCMoverController(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCMoverController;
   rd.readEntry("triggerTarget", info.zCMoverController.triggerTarget);
   rd.readEntry("moverMessage",  reinterpret_cast<uint32_t&>(info.zCMoverController.moverMessage));
   rd.readEntry("gotoFixedKey",  info.zCMoverController.gotoFixedKey);
   }
 
-static void read_zCVob_zCCamTrj(zCVobData &info, ZenParser &parser, const ZenParser::ChunkHeader& header, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCCamTrj(zCVobData &info, ZenParser &parser, Rd& rd, const ZenParser::ChunkHeader& header, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCCamTraj_KeyFrame;
   info.aiReference = header.objectID; // FIXME: other field than aiReference
   if(parser.getZenHeader().fileType==ZenLoad::ZenParser::FT_ASCII && version==ZenLoad::ZenParser::FileVersion::Gothic1) { // FIXME: not sure but there are two CSCamera versions, one with more data and one with less
@@ -302,10 +308,10 @@ static void read_zCVob_zCCamTrj(zCVobData &info, ZenParser &parser, const ZenPar
   rd.readEntry(""                   , &info.zCCamTraj_KeyFrame.originalPose, sizeof(info.zCCamTraj_KeyFrame.originalPose));
   }
 
-static void read_zCVob_zCCSCamera(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCCSCamera(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCCSCamera;
   if(parser.getZenHeader().fileType==ZenLoad::ZenParser::FT_ASCII && version==ZenLoad::ZenParser::FileVersion::Gothic1) {
     rd.readEntry("sleepMode",   info.zCCSCamera.sleepMode,true);
@@ -352,11 +358,11 @@ static void read_zCVob_zCCSCamera(zCVobData &info, ZenParser &parser, ZenParser:
     }
   }
 
-static void read_zCVob_zCTrigger_zCTriggerList(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_zCTrigger(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCTrigger_zCTriggerList(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_zCTrigger(info,parser,rd,version);
 
   uint8_t count=0;
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCTriggerList;
 
   rd.readEntry("listProcess", info.zCTriggerList.listProcess);
@@ -375,19 +381,19 @@ static void read_zCVob_zCTrigger_zCTriggerList(zCVobData &info, ZenParser &parse
     }
   }
 
-static void read_zCVob_zCTrigger_oCTriggerScript(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_zCTrigger(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCTrigger_oCTriggerScript(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_zCTrigger(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCTriggerScript;
   rd.readEntry("scriptFunc"   , info.zCTriggerScript.scriptFunc);
   rd.readEntry("triggerTarget", info.zCTriggerScript.triggerTarget,true);
   }
 
-static void read_zCVob_oCMOB(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCMOB(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_oCMOB;
   rd.readEntry("focusName",       info.oCMOB.focusName);
   rd.readEntry("hitpoints",       info.oCMOB.hitpoints);
@@ -402,10 +408,10 @@ static void read_zCVob_oCMOB(zCVobData &info, ZenParser &parser, ZenParser::File
   rd.readEntry("isDestroyed",     info.oCMOB.isDestroyed);
   }
 
-static void read_zCVob_oCMOB_oCMobInter(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_oCMOB(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCMOB_oCMobInter(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_oCMOB(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_oCMobInter;
   if(parser.getZenHeader().fileType==ZenParser::EFileType::FT_ASCII && version==ZenLoad::ZenParser::FileVersion::Gothic1) { // FIXME: relax this condition if known if this applies to only gothic 1 asciis or also binSafe
     rd.readEntry("state"      , info.oCMobInter.state,true);
@@ -419,44 +425,47 @@ static void read_zCVob_oCMOB_oCMobInter(zCVobData &info, ZenParser &parser, ZenP
   rd.readEntry("rewind",        info.oCMobInter.rewind);
   }
 
-static void read_zCVob_oCMOB_oCMobInter_oCMobBed(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_oCMOB_oCMobInter(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCMOB_oCMobInter_oCMobBed(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_oCMOB_oCMobInter(info,parser,rd,version);
   info.vobType = zCVobData::VT_oCMobBed;
   }
 
-static void read_zCVob_oCMOB_oCMobInter_oCMobDoor(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_oCMOB_oCMobInter(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCMOB_oCMobInter_oCMobDoor(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_oCMOB_oCMobInter(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_oCMobDoor;
   rd.readEntry("locked",      info.oCMobLockable.locked);
   rd.readEntry("keyInstance", info.oCMobLockable.keyInstance);
   rd.readEntry("pickLockStr", info.oCMobLockable.pickLockStr);
   }
 
-static void read_zCVob_oCMOB_oCMobInter_oCMobFire(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_oCMOB_oCMobInter(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCMOB_oCMobInter_oCMobFire(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_oCMOB_oCMobInter(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_oCMobFire;
   rd.readEntry("fireSlot",        info.oCMobFire.fireSlot);
   rd.readEntry("fireVobtreeName", info.oCMobFire.fireVobtreeName);
   }
 
-static void read_zCVob_oCMOB_oCMobInter_oCMobLadder(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_oCMOB_oCMobInter(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCMOB_oCMobInter_oCMobLadder(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_oCMOB_oCMobInter(info,parser,rd,version);
   info.vobType = zCVobData::VT_oCMobLadder;
   }
 
-static void read_zCVob_oCMOB_oCMobInter_oCMobSwitch(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_oCMOB_oCMobInter(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCMOB_oCMobInter_oCMobSwitch(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_oCMOB_oCMobInter(info,parser,rd,version);
   info.vobType = zCVobData::VT_oCMobSwitch;
   }
 
-static void read_zCVob_oCMOB_oCMobInter_oCMobContainer(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_oCMOB_oCMobInter(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCMOB_oCMobInter_oCMobContainer(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_oCMOB_oCMobInter(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_oCMobContainer;
   rd.readEntry("locked",      info.oCMobLockable.locked);
   rd.readEntry("keyInstance", info.oCMobLockable.keyInstance);
@@ -464,13 +473,14 @@ static void read_zCVob_oCMOB_oCMobInter_oCMobContainer(zCVobData &info, ZenParse
   rd.readEntry("contains",    info.oCMobContainer.contains);
   }
 
-static void read_zCVob_oCMOB_oCMobInter_oCMobWheel(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_oCMOB_oCMobInter(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCMOB_oCMobInter_oCMobWheel(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_oCMOB_oCMobInter(info,parser,rd,version);
   info.vobType = zCVobData::VT_oCMobWheel;
   }
 
-static void read_LightData(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  auto& rd = *parser.getImpl();
+template<class Rd>
+static void read_LightData(zCVobData &info, ZenParser &/*parser*/, Rd& rd, ZenParser::FileVersion version) {
   // lightPresetInUse or presetName
   rd.readEntry("",                 info.zCVobLight.lightPresetInUse);
   rd.readEntry("lightType",        info.zCVobLight.lightType);
@@ -540,21 +550,23 @@ static void read_LightData(zCVobData &info, ZenParser &parser, ZenParser::FileVe
     }
   }
 
-static void read_zCVob_zCVobLight(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCVobLight(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   info.vobType = zCVobData::VT_zCVobLight;
-  read_LightData(info,parser,version);
+  read_LightData(info,parser,rd,version);
   }
 
-static void read_zCVob_zCVobLightPreset(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
+template<class Rd>
+static void read_zCVob_zCVobLightPreset(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
   info.vobType = zCVobData::VT_zCVobLightPreset;
-  read_LightData(info,parser,version);
+  read_LightData(info,parser,rd,version);
   }
 
-static void read_zCVob_zCVobSound(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCVobSound(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCVobSound;
   rd.readEntry("sndVolume",       info.zCVobSound.sndVolume);
   rd.readEntry("sndMode",         reinterpret_cast<uint32_t&>(info.zCVobSound.sndMode));
@@ -569,20 +581,20 @@ static void read_zCVob_zCVobSound(zCVobData &info, ZenParser &parser, ZenParser:
   rd.readEntry("sndName",         info.zCVobSound.sndName);
   }
 
-static void read_zCVob_zCVobSound_zCVobSoundDaytime(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_zCVobSound(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCVobSound_zCVobSoundDaytime(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_zCVobSound(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCVobSoundDaytime;
   rd.readEntry("sndStartTime", info.zCVobSoundDaytime.sndStartTime);
   rd.readEntry("sndEndTime",   info.zCVobSoundDaytime.sndEndTime);
   rd.readEntry("sndName2",     info.zCVobSoundDaytime.sndName2);
   }
 
-static void read_zCVob_oCZoneMusic(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCZoneMusic(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_oCZoneMusic;
   rd.readEntry("enabled",     info.oCZoneMusic.enabled);
   rd.readEntry("priority",    info.oCZoneMusic.priority);
@@ -592,30 +604,32 @@ static void read_zCVob_oCZoneMusic(zCVobData &info, ZenParser &parser, ZenParser
   rd.readEntry("loop",        info.oCZoneMusic.loop);
   }
 
-static void read_zCVob_oCZoneMusic_oCZoneMusicDefault(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_oCZoneMusic(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCZoneMusic_oCZoneMusicDefault(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_oCZoneMusic(info,parser,rd,version);
   info.vobType = zCVobData::VT_oCZoneMusicDefault;
   }
 
-static void read_zCVob_zCVobReverb(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCVobReverb(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCZoneReverb;
   rd.readEntry("reverbPreset",   info.zCZoneReverb.reverbPreset);
   rd.readEntry("reverbWeight",   info.zCZoneReverb.reverbWeight);
   rd.readEntry("innerRangePerc", info.zCZoneReverb.innerRangePerc);
   }
 
-static void read_zCVob_zCVobReverb_zCVobReverbDefault(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_zCVobReverb(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCVobReverb_zCVobReverbDefault(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_zCVobReverb(info,parser,rd,version);
   info.vobType = zCVobData::VT_zCZoneReverbDefault;
   }
 
-static void read_zCVob_oCZoneZFog(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCZoneZFog(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_ocZoneFog;
   rd.readEntry("fogRangeCenter", info.zCZoneZFog.fogRangeCenter);
   rd.readEntry("innerRangePerc", info.zCZoneZFog.innerRangePerc);
@@ -626,30 +640,32 @@ static void read_zCVob_oCZoneZFog(zCVobData &info, ZenParser &parser, ZenParser:
     }
   }
 
-static void read_zCVob_oCZoneZFog_zCZoneZFogDefault(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_oCZoneZFog(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCZoneZFog_zCZoneZFogDefault(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_oCZoneZFog(info,parser,rd,version);
   info.vobType = zCVobData::VT_ocZoneFogDefault;
   }
 
-static void read_zCVob_zCZoneVobFarPlane(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCZoneVobFarPlane(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCZoneVobFarPlane;
   rd.readEntry("vobFarPlaneZ", info.zCZoneVobFarPlane.farPlaneZ);
   rd.readEntry("innerRangePerc", info.zCZoneVobFarPlane.innerRangePerc);
   }
 
-static void read_zCVob_zCZoneVobFarPlane_zCZoneVobFarPlaneDefault(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_zCZoneVobFarPlane(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCZoneVobFarPlane_zCZoneVobFarPlaneDefault(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_zCZoneVobFarPlane(info,parser,rd,version);
   info.vobType = zCVobData::VT_zCZoneVobFarPlaneDefault;
   }
 
-static void read_zCVob_zCTrigger_zCMover(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version){
-  read_zCVob_zCTrigger(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCTrigger_zCMover(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version){
+  read_zCVob_zCTrigger(info,parser,rd,version);
   uint16_t numKeyframes=0;
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCMover;
   rd.readEntry("moverBehavior",      reinterpret_cast<uint32_t&>(info.zCMover.moverBehavior));
   rd.readEntry("touchBlockerDamage", info.zCMover.touchBlockerDamage);
@@ -677,54 +693,54 @@ static void read_zCVob_zCTrigger_zCMover(zCVobData &info, ZenParser &parser, Zen
   rd.readEntry("sfxUseLocked",  info.zCMover.sfxUseLocked);
   }
 
-static void read_zCVob_zCTrigger_oCTriggerChangeLevel(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_zCTrigger(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCTrigger_oCTriggerChangeLevel(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_zCTrigger(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_oCTriggerChangeLevel;
   rd.readEntry("levelName",    info.oCTriggerChangeLevel.levelName);
   rd.readEntry("startVobName", info.oCTriggerChangeLevel.startVobName);
   }
 
-static void read_zCVob_zCTrigger_zCTriggerWorldStart(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCTrigger_zCTriggerWorldStart(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCTriggerWorldStart;
   rd.readEntry("triggerTarget",     info.oCTriggerWorldStart.triggerTarget);
   rd.readEntry("fireOnlyFirstTime", info.oCTriggerWorldStart.fireOnlyFirstTime);
   }
 
-static void read_zCVob_zCPFXController(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCPFXController(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCPFXController;
   rd.readEntry("pfxName",         info.zCPFXController.pfxName);
   rd.readEntry("killVobWhenDone", info.zCPFXController.killVobWhenDone);
   rd.readEntry("pfxStartOn",      info.zCPFXController.pfxStartOn);
   }
 
-static void read_zCVob_zcVobAnimate(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zcVobAnimate(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCVobAnimate;
   rd.readEntry("startOn", info.zCVobAnimate.startOn);
   }
 
-static void read_zCVob_zcVobLensFlare(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zcVobLensFlare(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCVobLensFlare;
   rd.readEntry("lensFlareFx", info.zCVobLensFlare.lensFlareFx);
   }
 
-static void read_zCVob_oCTouchDamage(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_oCTouchDamage(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_oCTouchDamage;
   rd.readEntry("damage",  info.oCTouchDamage.damage);
 
@@ -742,51 +758,56 @@ static void read_zCVob_oCTouchDamage(zCVobData &info, ZenParser &parser, ZenPars
   rd.readEntry("damageCollType",       info.oCTouchDamage.damageCollType);
   }
 
-static void read_zCVob_zCTouchAnimate(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCTouchAnimate(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   }
 
-static void read_zCVob_zCTouchAnimate_zCTouchAnimateSound(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob_zCTouchAnimate(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCTouchAnimate_zCTouchAnimateSound(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob_zCTouchAnimate(info,parser,rd,version);
 
-  auto& rd = *parser.getImpl();
   info.vobType = zCVobData::VT_zCTouchAnimateSound;
   rd.readEntry("sfxTouch", info.zCTouchAnimateSound.sfxTouch);
   }
 
-static void read_zCVob_zCEarthquake(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCEarthquake(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   
   info.vobType = zCVobData::VT_zCEarthQuake;
-  auto& rd = *parser.getImpl();
   rd.readEntry("radius", info.zCEarthQuake.radius);
   rd.readEntry("timeSec", info.zCEarthQuake.timeSec);
   rd.readEntry("amplitudeCM", info.zCEarthQuake.amplitudeCM);
   }
 
-static void read_zCVob_zCVobScreenFX(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCVobScreenFX(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   info.vobType = zCVobData::VT_zCVobScreenFX;
   }
 
-static void read_zCVob_zCMusicControler(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_zCMusicControler(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   info.vobType = zCVobData::VT_zCMusicControler;
   }
 
-static void read_zCVob_ocVisualFX(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_zCVob_ocVisualFX(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   info.vobType = zCVobData::VT_ocVisualFX;
   }
 
-static void read_ocVisFX_MultiTarget(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
-  read_zCVob(info,parser,version);
+template<class Rd>
+static void read_ocVisFX_MultiTarget(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
+  read_zCVob(info,parser,rd,version);
   info.vobType = zCVobData::VT_ocVisFX_MultiTarget;
   }
 
-static void read_zCLensFlare(zCVobData &info, ZenParser &parser, ZenParser::FileVersion /*version*/) {
+template<class Rd>
+static void read_zCLensFlare(zCVobData &info, ZenParser &/*parser*/, Rd& rd, ZenParser::FileVersion /*version*/) {
   info.vobType = zCVobData::VT_zCLensFlare;
-  auto& rd = *parser.getImpl();
 
   rd.readEntry("texName",  info.zCFlare.texName);
   rd.readEntry("type",     reinterpret_cast<uint32_t&>(info.zCFlare.type));
@@ -798,9 +819,9 @@ static void read_zCLensFlare(zCVobData &info, ZenParser &parser, ZenParser::File
   rd.readEntry("fadeScale",info.zCFlare.fadeScale,true);
   }
 
-static void read_zCLensFlareFX(zCVobData &info, ZenParser &parser, ZenParser::FileVersion version) {
+template<class Rd>
+static void read_zCLensFlareFX(zCVobData &info, ZenParser &parser, Rd& rd, ZenParser::FileVersion version) {
   info.vobType = zCVobData::VT_zCLensFlareFX;
-  auto& rd = *parser.getImpl();
   rd.readEntry("name",  info.zcLensFlareFX.name);
   int numFlares;
   rd.readEntry("numFlares",numFlares);
@@ -808,19 +829,21 @@ static void read_zCLensFlareFX(zCVobData &info, ZenParser &parser, ZenParser::Fi
     ZenParser::ChunkHeader header;
     parser.readChunkStart(header);
     zCVobData flare;
-    read_zCLensFlare(flare,parser,version);
+    read_zCLensFlare(flare,parser,rd,version);
     info.childVobs.emplace_back(flare);
     parser.readChunkEnd();
     }
   rd.readEntry("fadeScale",info.zCFlare.posScale,true);
   }
 
-static void read_zReference(zCVobData &info, ZenParser &/*parser*/, const ZenParser::ChunkHeader& header, ZenParser::FileVersion /*version*/) {
+template<class Rd>
+static void read_zReference(zCVobData &info, ZenParser &/*parser*/, Rd& /*rd*/, const ZenParser::ChunkHeader& header, ZenParser::FileVersion /*version*/) {
   info.vobType = zCVobData::VT_zReference;
   info.aiReference = header.objectID; // FIXME: aiReference may be the wrong field to write into
   }
 
-static void readObjectData(zCVobData &info, ZenParser &parser,
+template<class Rd>
+static void readObjectData(zCVobData &info, ZenParser &parser, Rd& rd,
                            const ZenParser::ChunkHeader& header, ZenParser::FileVersion version) {
   switch(header.classId) {
     case ZenParser::zUnknown:
@@ -842,112 +865,112 @@ static void readObjectData(zCVobData &info, ZenParser &parser,
     case ZenParser::oCMsgConversation:
       return;
     case ZenParser::zReference:
-      return read_zReference(info,parser,header,version);
+      return read_zReference(info,parser,rd,header,version);
     case ZenParser::zCVobStair:
-      return read_zCVob_zCVobStair(info,parser,version);
+      return read_zCVob_zCVobStair(info,parser,rd,version);
     case ZenParser::zCVob:
-      return read_zCVob(info,parser,version);
+      return read_zCVob(info,parser,rd,version);
     case ZenParser::zCVobLevelCompo:
-      return read_zCVobLevelCompo(info,parser,version);
+      return read_zCVobLevelCompo(info,parser,rd,version);
     case ZenParser::zCDecal:
-      return read_zCDecal(info,parser,version);
+      return read_zCDecal(info,parser,rd,version);
     case ZenParser::oCItem:
-      return read_zCVob_oCItem(info,parser,version);
+      return read_zCVob_oCItem(info,parser,rd,version);
     case ZenParser::oCMOB:
-      return read_zCVob_oCMOB(info,parser,version);
+      return read_zCVob_oCMOB(info,parser,rd,version);
     case ZenParser::oCMobInter:
-      return read_zCVob_oCMOB_oCMobInter(info,parser,version);
+      return read_zCVob_oCMOB_oCMobInter(info,parser,rd,version);
     case ZenParser::oCMobBed:
-      return read_zCVob_oCMOB_oCMobInter_oCMobBed(info,parser,version);
+      return read_zCVob_oCMOB_oCMobInter_oCMobBed(info,parser,rd,version);
     case ZenParser::oCMobFire:
-      return read_zCVob_oCMOB_oCMobInter_oCMobFire(info,parser,version);
+      return read_zCVob_oCMOB_oCMobInter_oCMobFire(info,parser,rd,version);
     case ZenParser::oCMobLadder:
-      return read_zCVob_oCMOB_oCMobInter_oCMobLadder(info,parser,version);
+      return read_zCVob_oCMOB_oCMobInter_oCMobLadder(info,parser,rd,version);
     case ZenParser::oCMobSwitch:
-      return read_zCVob_oCMOB_oCMobInter_oCMobSwitch(info,parser,version);
+      return read_zCVob_oCMOB_oCMobInter_oCMobSwitch(info,parser,rd,version);
     case ZenParser::oCMobWheel:
-      return read_zCVob_oCMOB_oCMobInter_oCMobWheel(info,parser,version);
+      return read_zCVob_oCMOB_oCMobInter_oCMobWheel(info,parser,rd,version);
     case ZenParser::oCMobContainer:
-      return read_zCVob_oCMOB_oCMobInter_oCMobContainer(info,parser,version);
+      return read_zCVob_oCMOB_oCMobInter_oCMobContainer(info,parser,rd,version);
     case ZenParser::oCMobDoor:
-      return read_zCVob_oCMOB_oCMobInter_oCMobDoor(info,parser,version);
+      return read_zCVob_oCMOB_oCMobInter_oCMobDoor(info,parser,rd,version);
     case ZenParser::zCPFXController:
-      return read_zCVob_zCPFXController(info,parser,version);
+      return read_zCVob_zCPFXController(info,parser,rd,version);
     case ZenParser::zCVobAnimate:
-      return read_zCVob_zcVobAnimate(info,parser,version);
+      return read_zCVob_zcVobAnimate(info,parser,rd,version);
     case ZenParser::zCVobLensFlare:
-      return read_zCVob_zcVobLensFlare(info,parser,version);
+      return read_zCVob_zcVobLensFlare(info,parser,rd,version);
     case ZenParser::zCVobLight:
-      return read_zCVob_zCVobLight(info,parser,version);
+      return read_zCVob_zCVobLight(info,parser,rd,version);
     case ZenParser::zCVobLightPreset:
-      return read_zCVob_zCVobLightPreset(info,parser,version);
+      return read_zCVob_zCVobLightPreset(info,parser,rd,version);
     case ZenParser::zCVobSpot:
-      return read_zCVob_zCVobSpot(info,parser,version);
+      return read_zCVob_zCVobSpot(info,parser,rd,version);
     case ZenParser::zCVobStartpoint:
-      return read_zCVob_zCVobStartpoint(info,parser,version);
+      return read_zCVob_zCVobStartpoint(info,parser,rd,version);
     case ZenParser::zCVobSound:
-      return read_zCVob_zCVobSound(info,parser,version);
+      return read_zCVob_zCVobSound(info,parser,rd,version);
     case ZenParser::zCVobSoundDaytime:
-      return read_zCVob_zCVobSound_zCVobSoundDaytime(info,parser,version);
+      return read_zCVob_zCVobSound_zCVobSoundDaytime(info,parser,rd,version);
     case ZenParser::oCZoneMusic:
-      return read_zCVob_oCZoneMusic(info,parser,version);
+      return read_zCVob_oCZoneMusic(info,parser,rd,version);
     case ZenParser::oCZoneMusicDefault:
-      return read_zCVob_oCZoneMusic_oCZoneMusicDefault(info,parser,version);
+      return read_zCVob_oCZoneMusic_oCZoneMusicDefault(info,parser,rd,version);
     case ZenParser::zCZoneReverb:
-      return read_zCVob_zCVobReverb(info,parser,version);
+      return read_zCVob_zCVobReverb(info,parser,rd,version);
     case ZenParser::zCZoneReverbDefault:
-      return read_zCVob_zCVobReverb_zCVobReverbDefault(info,parser,version);
+      return read_zCVob_zCVobReverb_zCVobReverbDefault(info,parser,rd,version);
     case ZenParser::zCZoneZFog:
-      return read_zCVob_oCZoneZFog(info,parser,version);
+      return read_zCVob_oCZoneZFog(info,parser,rd,version);
     case ZenParser::zCZoneZFogDefault:
-      return read_zCVob_oCZoneZFog_zCZoneZFogDefault(info,parser,version);
+      return read_zCVob_oCZoneZFog_zCZoneZFogDefault(info,parser,rd,version);
     case ZenParser::zCZoneVobFarPlane:
-      return read_zCVob_zCZoneVobFarPlane(info,parser,version);
+      return read_zCVob_zCZoneVobFarPlane(info,parser,rd,version);
     case ZenParser::zCZoneVobFarPlaneDefault:
-      return read_zCVob_zCZoneVobFarPlane_zCZoneVobFarPlaneDefault(info,parser,version);
+      return read_zCVob_zCZoneVobFarPlane_zCZoneVobFarPlaneDefault(info,parser,rd,version);
     case ZenParser::zCMessageFilter:
-      return read_zCMessageFilter(info,parser,version);
+      return read_zCMessageFilter(info,parser,rd,version);
     case ZenParser::zCCodeMaster:
-      return read_zCCodeMaster(info,parser,version);
+      return read_zCCodeMaster(info,parser,rd,version);
     case ZenParser::zCTrigger:
     case ZenParser::oCCSTrigger:
-      return read_zCVob_zCTrigger(info,parser,version);
+      return read_zCVob_zCTrigger(info,parser,rd,version);
     case ZenParser::zCTriggerList:
-      return read_zCVob_zCTrigger_zCTriggerList(info,parser,version);
+      return read_zCVob_zCTrigger_zCTriggerList(info,parser,rd,version);
     case ZenParser::oCTriggerScript:
-      return read_zCVob_zCTrigger_oCTriggerScript(info,parser,version);
+      return read_zCVob_zCTrigger_oCTriggerScript(info,parser,rd,version);
     case ZenParser::zCMover:
-      return read_zCVob_zCTrigger_zCMover(info,parser,version);
+      return read_zCVob_zCTrigger_zCMover(info,parser,rd,version);
     case ZenParser::oCTriggerChangeLevel:
-      return read_zCVob_zCTrigger_oCTriggerChangeLevel(info,parser,version);
+      return read_zCVob_zCTrigger_oCTriggerChangeLevel(info,parser,rd,version);
     case ZenParser::zCTriggerWorldStart:
-      return read_zCVob_zCTrigger_zCTriggerWorldStart(info,parser,version);
+      return read_zCVob_zCTrigger_zCTriggerWorldStart(info,parser,rd,version);
     case ZenParser::zCTriggerUntouch:
-      return read_zCVob_zCTrigger_zCTriggerUntouch(info,parser,version);
+      return read_zCVob_zCTrigger_zCTriggerUntouch(info,parser,rd,version);
     case ZenParser::zCMoverController:
-      return read_zCVob_zCTrigger_zCMoverController(info,parser,version);
+      return read_zCVob_zCTrigger_zCMoverController(info,parser,rd,version);
     case ZenParser::zCCSCamera:
-      return read_zCVob_zCCSCamera(info,parser,version);
+      return read_zCVob_zCCSCamera(info,parser,rd,version);
     case ZenParser::zCCamTrj_KeyFrame:
-      return read_zCVob_zCCamTrj(info,parser,header,version);
+      return read_zCVob_zCCamTrj(info,parser,rd,header,version);
     case ZenParser::oCTouchDamage:
-      return read_zCVob_oCTouchDamage(info,parser,version);
+      return read_zCVob_oCTouchDamage(info,parser,rd,version);
     case ZenParser::zCTouchAnimate:
-      return read_zCVob_zCTouchAnimate(info, parser, version);
+      return read_zCVob_zCTouchAnimate(info, parser,rd, version);
     case ZenParser::zCTouchAnimateSound:
-      return read_zCVob_zCTouchAnimate_zCTouchAnimateSound(info, parser, version);
+      return read_zCVob_zCTouchAnimate_zCTouchAnimateSound(info, parser,rd, version);
     case ZenParser::zCEarthquake:
-      return read_zCVob_zCEarthquake(info,parser,version);
+      return read_zCVob_zCEarthquake(info,parser,rd,version);
     case ZenParser::zCVobScreenFX:
-      return read_zCVob_zCVobScreenFX(info,parser,version);
+      return read_zCVob_zCVobScreenFX(info,parser,rd,version);
     case ZenParser::zCMusicControler:
-      return read_zCVob_zCMusicControler(info,parser,version);
+      return read_zCVob_zCMusicControler(info,parser,rd,version);
     case ZenParser::ocVisualFX:
-      return read_zCVob_ocVisualFX(info,parser,version);
+      return read_zCVob_ocVisualFX(info,parser,rd,version);
     case ZenParser::ocVisFX_MultiTarget:
-      return read_ocVisFX_MultiTarget(info,parser,version);
+      return read_ocVisFX_MultiTarget(info,parser,rd,version);
     case ZenParser::zCLensFlareFX:
-      return read_zCLensFlareFX(info,parser,version);
+      return read_zCLensFlareFX(info,parser,rd,version);
     default:
       LogInfo() << "skipping unsupported zCVob, classId = \"" << header.classId << "\"";
       break;
@@ -958,7 +981,9 @@ static void readObjectData(zCVobData &info, ZenParser &parser,
 
 void zCVob::readObjectData(zCVobData &info, ZenParser &parser,
                            const ZenParser::ChunkHeader& header, ZenParser::FileVersion version) {
-  ::readObjectData(info,parser,header,version);
+  withEntryReader(parser,[&](auto& rd) {
+    ::readObjectData(info,parser,rd,header,version);
+    });
   if(!parser.readChunkEnd())
     LogInfo() << " No proper read";
   }
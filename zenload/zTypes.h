@@ -1396,6 +1396,26 @@ namespace ZenLoad
         size_t                indexOffset = 0;
         size_t                indexSize   = 0;
         std::vector<int16_t>  triangleLightmapIndices;  // Index values to the texture found in zCMesh
+        size_t                clusterOffset = 0;        // Range in clusters, see MeshOptimizer::buildClusters()
+        size_t                clusterCount  = 0;
+      };
+
+      /**
+       * @brief Small, contiguous part of the index-range of a sub-mesh, with bounds to cull it by
+       */
+      struct Cluster
+      {
+        size_t        indexOffset  = 0;
+        size_t        indexSize    = 0;
+        ZMath::float3 bbox[2];
+        ZMath::float3 sphereCenter;
+        float         sphereRadius = 0;
+
+        // All triangles face away from a camera at c if dot(normalize(coneApex - c), coneAxis) >= coneCutoff.
+        // Facing follows the winding of the indices: cross(p1-p0, p2-p0). A cutoff above 1 disables the test.
+        ZMath::float3 coneApex;
+        ZMath::float3 coneAxis;
+        float         coneCutoff   = 2;
       };
 
       std::vector<WorldTriangle> triangles;  // Use index / 3 to access these
@@ -1403,10 +1423,49 @@ namespace ZenLoad
       std::vector<uint32_t>      indices;
       std::vector<uint32_t>      verticesId; // only for morph meshes
       std::vector<SubMesh>       subMeshes;
+      std::vector<Cluster>       clusters;
       ZMath::float3              bbox[2];
       bool                       isUsingAlphaTest = false;
     };
 
+    /**
+     * @brief Packed world-mesh split into tiles, which each own a range of the vertices and indices, so they
+     *        can be loaded and dropped one by one. See MeshTiling.
+     */
+    struct TiledMesh
+    {
+      /**
+       * @brief Triangles of one sub-mesh of the PackedMesh the tiles were made from, inside a tile
+       */
+      struct Part
+      {
+        size_t subMesh     = 0;
+        size_t indexOffset = 0;
+        size_t indexSize   = 0;
+      };
+
+      struct Tile
+      {
+        size_t        vertexOffset = 0;
+        size_t        vertexCount  = 0;
+        size_t        indexOffset  = 0;  // Indices of a tile are relative to its vertexOffset
+        size_t        indexSize    = 0;
+        size_t        partOffset   = 0;
+        size_t        partCount    = 0;
+        ZMath::float3 bbox[2];
+
+        int32_t       x = 0, z = 0;                           // Cell, if made from a grid
+        uint32_t      bspNode = zCBspNode::INVALID_NODE;      // Root of the subtree, if made from a bsp-tree
+      };
+
+      std::vector<WorldVertex> vertices;
+      std::vector<uint32_t>    indices;
+      std::vector<int16_t>     triangleLightmapIndices;  // One per triangle, if the sub-meshes had them
+      std::vector<Part>        parts;
+      std::vector<Tile>        tiles;
+      ZMath::float3            bbox[2];
+    };
+
     struct PackedSkeletalMesh
     {
       struct SubMesh
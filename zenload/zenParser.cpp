@@ -2,10 +2,16 @@
 #include "zenParser.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <fstream>
+#include <istream>
+#include <ostream>
 #include <memory>
+#include <mutex>
+#include <thread>
 
+#include "asciiScan.h"
 #include "parserImplASCII.h"
 #include "parserImplBinSafe.h"
 #include "parserImplBinary.h"
@@ -16,14 +22,61 @@
 #include <cmath>
 #include "zenload/zTypes.h"
 #include <vdfs/fileIndex.h>
+#include "worldArena.h"
 
 using namespace ZenLoad;
 
+namespace internal
+{
+  /**
+   * @brief Collects what the waynet-reader streams
+   */
+  struct WayNetCollector : ZenParser::Visitor
+    {
+    explicit WayNetCollector(zCWayNetData& info):info(info){}
+
+    void onWaypoint(size_t /*index*/, const zCWaypointData& wp) override {
+      info.waypoints.push_back(wp);
+      }
+
+    void onEdge(size_t wp1, size_t wp2) override {
+      info.edges.emplace_back(wp1, wp2);
+      }
+
+    zCWayNetData& info;
+    };
+
+  /**
+   * @brief Collects the waynet into an ArenaWorldData
+   */
+  struct ArenaWayNetCollector : ZenParser::Visitor
+    {
+    explicit ArenaWayNetCollector(ArenaWorldData& info):info(info){}
+
+    void onWaypoint(size_t /*index*/, const zCWaypointData& wp) override {
+      ArenaWaypointData w;
+      w.wpName     = info.arena.store(wp.wpName);
+      w.waterDepth = wp.waterDepth;
+      w.underWater = wp.underWater;
+      w.position   = wp.position;
+      w.direction  = wp.direction;
+      info.waypoints.push_back(w);
+      }
+
+    void onEdge(size_t wp1, size_t wp2) override {
+      info.edges.emplace_back(wp1, wp2);
+      }
+
+    ArenaWorldData& info;
+    };
+}  // namespace internal
+
 /**
   * @brief reads a zen from a vdf
   */
 ZenParser::ZenParser(const std::string& file, const VDFS::FileIndex& vdfs) {
-  vdfs.getFileData(file, m_DataStorage);
+  vdfs.getFileView(file, m_DataStorage);
+  m_DataStorage.adviseSequential();
   m_Data     = m_DataStorage.data();
   m_DataSize = m_DataStorage.size();
   }
@@ -114,18 +167,33 @@ void ZenParser::readHeader(ZenHeader& header, ParserImpl*& impl) {
   impl->readImplHeader();
   }
 
-void ZenParser::readWorldMesh(oCWorldData& info) {
+void ZenParser::readWorldMesh(zCBspTreeData& bsp) {
   m_pWorldMesh = std::make_unique<ZenLoad::zCMesh>();
-  info.bspTree = zCBspTree::readObjectData(*this, m_pWorldMesh.get());
+  m_pWorldMesh->setNumThreads(m_WorldMeshThreads);
+  bsp = zCBspTree::readObjectData(*this, m_pWorldMesh.get());
   }
 
 /**
   * @brief Reads a chunk-header
   */
 bool ZenParser::readChunkStart(ChunkHeader& header) {
+  if(m_StreamingWindow>0)
+    releaseConsumed();
   return m_pParserImpl->readChunkStart(header);
   }
 
+/**
+  * @brief Drops everything further behind the current position than the streaming window
+  */
+void ZenParser::releaseConsumed() {
+  // Only drop in larger steps, every call is a syscall
+  if(m_Seek<m_ReleasedUpTo+2*m_StreamingWindow)
+    return;
+  const size_t end = m_Seek-m_StreamingWindow;
+  m_DataStorage.release(m_ReleasedUpTo, end-m_ReleasedUpTo);
+  m_ReleasedUpTo = end;
+  }
+
 /**
   * @brief Reads the end of a chunk. Returns true if there actually was an end. 
   *      Otherwise it will leave m_Seek untouched and return false.
@@ -203,15 +271,10 @@ std::string ZenParser::readString(bool skip) {
     skipSpaces();
 
   const char* begin = reinterpret_cast<const char*>(m_Data+m_Seek);
-  size_t      size  = 0;
-  while(m_Seek<m_DataSize) {
-    if(m_Data[m_Seek]=='\n' || m_Data[m_Seek]=='\r' || m_Data[m_Seek]=='\t' || m_Data[m_Seek]==' ' || m_Data[m_Seek]=='\0') {
-      ++m_Seek;
-      break;
-      }
-    ++size;
+  size_t      size  = m_Seek<m_DataSize ? AsciiScan::findWordEnd(m_Data+m_Seek,m_DataSize-m_Seek) : 0;
+  m_Seek += size;
+  if(m_Seek<m_DataSize)
     ++m_Seek;
-    }
 
   std::string str(begin,size);
   return str;
@@ -224,8 +287,8 @@ bool ZenParser::skipString(const std::string& pattern) {
   skipSpaces();
   bool retVal = true;
   if (pattern.empty()) {
-    while(m_Seek<m_DataSize && m_Data[m_Seek]!='\n' && m_Data[m_Seek]!=' ')
-      ++m_Seek;
+    if(m_Seek<m_DataSize)
+      m_Seek += AsciiScan::findAny<'\n',' '>(m_Data+m_Seek,m_DataSize-m_Seek);
     if(m_Seek<m_DataSize)
       ++m_Seek;
     }
@@ -248,20 +311,8 @@ bool ZenParser::skipString(const std::string& pattern) {
   * @brief Skips all whitespace-characters until it hits a non-whitespace one
   */
 void ZenParser::skipSpaces() {
-  bool search = true;
-  while (search && m_Seek < m_DataSize) {
-    switch (m_Data[m_Seek]) {
-      case ' ':
-      case '\r':
-      case '\t':
-      case '\n':
-        ++m_Seek;
-        break;
-      default:
-        search = false;
-        break;
-      }
-    }
+  if(m_Seek<m_DataSize)
+    m_Seek += AsciiScan::skipWhitespace(m_Data+m_Seek,m_DataSize-m_Seek);
   }
 
 /**
@@ -307,6 +358,9 @@ void ZenParser::readBinaryRaw(void* target, size_t numBytes) {
   if (target != nullptr && numBytes != 0) {
     std::memcpy(target, &m_Data[m_Seek], numBytes);
     m_Seek += numBytes;
+    // The world-mesh is mostly read through here and is the bulk of a level
+    if(m_StreamingWindow>0)
+      releaseConsumed();
     }
   }
 
@@ -326,11 +380,8 @@ char ZenParser::peekChar() const {
 */
 std::string ZenParser::readLine(bool skip) {
   const char* at = reinterpret_cast<const char*>(m_Data+m_Seek);
-  size_t      sz = 0;
-  while(m_Seek<m_DataSize && m_Data[m_Seek]!='\r' && m_Data[m_Seek]!='\t' && m_Data[m_Seek]!='\n' && m_Data[m_Seek]!='\0') {
-    sz++;
-    m_Seek++;
-    }
+  size_t      sz = m_Seek<m_DataSize ? AsciiScan::findLineEnd(m_Data+m_Seek,m_DataSize-m_Seek) : 0;
+  m_Seek += sz;
   std::string retVal(at,sz);
 
   // Skip trailing \n\r\0
@@ -346,11 +397,8 @@ bool ZenParser::readLine(char* buf, size_t size, bool skip) {
   auto seek0 = m_Seek;
 
   const char* at = reinterpret_cast<const char*>(m_Data+m_Seek);
-  size_t      sz = 0;
-  while(m_Seek<m_DataSize && m_Data[m_Seek]!='\r' && m_Data[m_Seek]!='\t' && m_Data[m_Seek]!='\n' && m_Data[m_Seek]!='\0') {
-    sz++;
-    m_Seek++;
-    }
+  size_t      sz = m_Seek<m_DataSize ? AsciiScan::findLineEnd(m_Data+m_Seek,m_DataSize-m_Seek) : 0;
+  m_Seek += sz;
 
   if(sz>=size) {
     m_Seek = seek0;
@@ -370,6 +418,51 @@ bool ZenParser::readLine(char* buf, size_t size, bool skip) {
 * @brief reads the main oCWorld-Object, found in the level-zens
 */
 void ZenParser::readWorld(oCWorldData& info, FileVersion version) {
+  bool isUncompressZen=true;
+
+  WorldChunkVisitor visitor;
+  visitor.onWorldMesh = [&]() {
+    readWorldMesh(info.bspTree);
+    isUncompressZen=false;
+    };
+  visitor.onVobTree = [&](uint32_t numChildren) {
+    info.numVobsTotal = 0;
+    info.rootVobs.resize(numChildren);
+    if(m_VobTreeThreads>1 && numChildren>1) {
+      info.numVobsTotal = readVobTreeParallel(info.rootVobs,version);
+      } else {
+      for(uint32_t i=0; i<numChildren; i++) {
+        info.numVobsTotal += readVobTree(info.rootVobs[i],version);
+        }
+      }
+    };
+  visitor.onWayNet = [&]() {
+    readWayNetData(info.waynet);
+    };
+  readWorldChunks(visitor);
+
+  if(isUncompressZen && info.rootVobs.size()>1) // NOTE: only emit this message for more than one rootVob, assuming those are level zen's and size==1 are VobBundles
+    LogInfo() << "ZEN: No world mesh given - probably an uncompressed zen file. Please provide a compressed zen, either ASCII or BinSafe format. Ignore this message if its a VobBundle zen";
+  }
+
+void ZenParser::readWorld(Visitor& visitor, FileVersion version) {
+  WorldChunkVisitor chunks;
+  chunks.onWorldMesh = [&]() {
+    zCBspTreeData bsp;
+    readWorldMesh(bsp);
+    visitor.onWorldMesh(bsp);
+    };
+  chunks.onVobTree = [&](uint32_t numChildren) {
+    for(uint32_t i=0; i<numChildren; i++)
+      visitVobTree(visitor,version);
+    };
+  chunks.onWayNet = [&]() {
+    readWayNetData(visitor);
+    };
+  readWorldChunks(chunks);
+  }
+
+void ZenParser::readWorldChunks(const WorldChunkVisitor& visitor) {
   LogInfo() << "ZEN: Reading world...";
 
   ChunkHeader worldHeader;
@@ -379,30 +472,22 @@ void ZenParser::readWorld(oCWorldData& info, FileVersion version) {
   if(worldHeader.classId!=ZenParser::zCWorld)
     throw std::runtime_error("Expected oCWorld:zCWorld-Chunk not found!");
 
-  bool isUncompressZen=true;
   while(!readChunkEnd()) {
     ZenParser::ChunkHeader header;
     readChunkStart(header);
 
     if(header.name == "MeshAndBsp") {
-      readWorldMesh(info);
+      visitor.onWorldMesh();
       readChunkEnd();
-      isUncompressZen=false;
       }
     else if(header.name == "VobTree") {
       uint32_t numChildren = 0;
       getImpl()->readEntry("", numChildren);
-      info.rootVobs.reserve(numChildren);
-
-      info.numVobsTotal = 0;
-      info.rootVobs.resize(numChildren);
-      for(uint32_t i=0; i<numChildren; i++) {
-        info.numVobsTotal += readVobTree(info.rootVobs[i],version);
-        }
+      visitor.onVobTree(numChildren);
       readChunkEnd();
       }
     else if (header.name == "WayNet") {
-      readWayNetData(info.waynet);
+      visitor.onWayNet();
       readChunkEnd();
       }
     else if (header.name == "EndMarker") {
@@ -415,8 +500,226 @@ void ZenParser::readWorld(oCWorldData& info, FileVersion version) {
     }
   if(!readSuccess)
     LogInfo() << "ZEN: No clean read of zen file - there could be following issues originating from this!!!";
-  if(isUncompressZen && info.rootVobs.size()>1) // NOTE: only emit this message for more than one rootVob, assuming those are level zen's and size==1 are VobBundles
-    LogInfo() << "ZEN: No world mesh given - probably an uncompressed zen file. Please provide a compressed zen, either ASCII or BinSafe format. Ignore this message if its a VobBundle zen";
+  }
+
+void ZenParser::readWorld(ArenaWorldData& info, FileVersion version) {
+  WorldChunkVisitor visitor;
+  visitor.onWorldMesh = [&]() {
+    readWorldMesh(info.bspTree);
+    };
+  visitor.onVobTree = [&](uint32_t numChildren) {
+    info.vobs.reserve(size_t(std::max(m_Header.objectCount, 0)));
+
+    // Reused for every vob, so its strings keep their capacity
+    zCVobData   scratch;
+    ChunkHeader vobHeader;
+    for(uint32_t i=0; i<numChildren; i++)
+      readVobTree(info, scratch, vobHeader, uint32_t(-1), version);
+    info.numRootVobs = numChildren;
+    };
+  visitor.onWayNet = [&]() {
+    internal::ArenaWayNetCollector collector(info);
+    info.waynetVersion = readWayNetData(collector);
+    };
+  readWorldChunks(visitor);
+  }
+
+void ZenParser::readVob(const ArenaVobData& arenaVob, zCVobData& vob, FileVersion version) {
+  const size_t seek0 = m_Seek;
+  m_Seek = arenaVob.offset;
+
+  ChunkHeader header;
+  readChunkStart(header);
+  vob.vobName     = std::move(header.name);
+  vob.vobType     = zCVobData::VT_Unknown;
+  vob.vobObjectID = header.objectID;
+  zCVob::readObjectData(vob, *this, header, version);
+
+  m_Seek = seek0;
+  }
+
+const std::vector<ZenParser::ChunkIndexEntry>& ZenParser::buildChunkIndex() {
+  // Values in BINARY archives carry no type, so there is no way to step over them
+  if(m_Header.fileType==FT_BINARY)
+    throw std::runtime_error("Chunk-index not supported for BINARY archives");
+
+  const size_t seek0 = m_Seek;
+  m_ChunkIndex.clear();
+
+  std::vector<uint32_t> open;
+  while(m_Seek<m_DataSize) {
+    const size_t start = m_Seek;
+
+    ChunkHeader header;
+    if(readChunkStart(header)) {
+      ChunkIndexEntry e;
+      e.offset   = start;
+      e.classId  = header.classId;
+      e.objectID = header.objectID;
+      e.version  = header.version;
+      e.parent   = open.empty() ? uint32_t(-1) : open.back();
+      e.name     = std::move(header.name);
+      open.push_back(uint32_t(m_ChunkIndex.size()));
+
+      // The world-mesh is a binary blob, even in ASCII-Files
+      const bool isMesh = (e.name=="MeshAndBsp");
+      m_ChunkIndex.emplace_back(std::move(e));
+      if(isMesh) {
+        BinaryFileInfo fileInfo{};
+        readStructure(fileInfo);
+        m_Seek = std::min(m_DataSize, m_Seek+size_t(fileInfo.size));
+        }
+      continue;
+      }
+
+    if(readChunkEnd()) {
+      if(!open.empty()) {
+        ChunkIndexEntry& e = m_ChunkIndex[open.back()];
+        e.size = m_Seek-e.offset;
+        open.pop_back();
+        }
+      continue;
+      }
+
+    skipEntry();
+    if(m_Seek<=start)
+      break;
+    }
+
+  // Unterminated chunks reach to the end of the file
+  for(auto i:open)
+    m_ChunkIndex[i].size = m_DataSize-m_ChunkIndex[i].offset;
+
+  m_Seek = seek0;
+  return m_ChunkIndex;
+  }
+
+namespace
+{
+  const char     CHUNK_INDEX_MAGIC[4] = {'Z','C','I','X'};
+  const uint32_t CHUNK_INDEX_VERSION  = 1;
+
+  template<class T>
+  void writeValue(std::ostream& out, const T& v) {
+    out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+
+  template<class T>
+  bool readValue(std::istream& in, T& v) {
+    return bool(in.read(reinterpret_cast<char*>(&v), sizeof(v)));
+    }
+}
+
+bool ZenParser::writeChunkIndex(std::ostream& out) const {
+  out.write(CHUNK_INDEX_MAGIC, sizeof(CHUNK_INDEX_MAGIC));
+  writeValue(out, CHUNK_INDEX_VERSION);
+  writeValue(out, uint64_t(m_DataSize));
+  writeValue(out, uint32_t(m_ChunkIndex.size()));
+  for(auto& e:m_ChunkIndex) {
+    writeValue(out, uint64_t(e.offset));
+    writeValue(out, uint64_t(e.size));
+    writeValue(out, uint32_t(e.classId));
+    writeValue(out, e.objectID);
+    writeValue(out, e.version);
+    writeValue(out, e.parent);
+    writeValue(out, uint32_t(e.name.size()));
+    out.write(e.name.data(), std::streamsize(e.name.size()));
+    }
+  return bool(out);
+  }
+
+bool ZenParser::readChunkIndex(std::istream& in) {
+  char     magic[4] = {};
+  uint32_t version  = 0;
+  uint64_t dataSize = 0;
+  uint32_t count    = 0;
+  if(!in.read(magic, sizeof(magic)) || std::memcmp(magic, CHUNK_INDEX_MAGIC, sizeof(magic))!=0)
+    return false;
+  if(!readValue(in, version) || version!=CHUNK_INDEX_VERSION)
+    return false;
+  if(!readValue(in, dataSize) || dataSize!=m_DataSize || !readValue(in, count) || count>m_DataSize)
+    return false;
+
+  std::vector<ChunkIndexEntry> index(count);
+  for(size_t i=0; i<index.size(); ++i) {
+    ChunkIndexEntry& e = index[i];
+    uint64_t offset = 0, size = 0;
+    uint32_t classId = 0, nameLen = 0;
+    if(!readValue(in, offset) || !readValue(in, size) || !readValue(in, classId) ||
+       !readValue(in, e.objectID) || !readValue(in, e.version) || !readValue(in, e.parent) ||
+       !readValue(in, nameLen))
+      return false;
+    // Enclosing chunks always come first
+    if(offset+size>m_DataSize || nameLen>size || (e.parent!=uint32_t(-1) && e.parent>=i))
+      return false;
+    e.offset  = size_t(offset);
+    e.size    = size_t(size);
+    e.classId = ZenClass(classId);
+    e.name.resize(nameLen);
+    if(!in.read(&e.name[0], std::streamsize(nameLen)))
+      return false;
+    }
+  m_ChunkIndex = std::move(index);
+  return true;
+  }
+
+std::vector<size_t> ZenParser::findChunks(ZenClass classId) const {
+  std::vector<size_t> ret;
+  for(size_t i=0; i<m_ChunkIndex.size(); ++i)
+    if(m_ChunkIndex[i].classId==classId)
+      ret.push_back(i);
+  return ret;
+  }
+
+std::vector<size_t> ZenParser::findChunks(const std::string& name) const {
+  std::vector<size_t> ret;
+  for(size_t i=0; i<m_ChunkIndex.size(); ++i)
+    if(m_ChunkIndex[i].name==name)
+      ret.push_back(i);
+  return ret;
+  }
+
+bool ZenParser::readWayNet(zCWayNetData& info) {
+  auto chunks = findChunks("WayNet");
+  if(chunks.empty())
+    return false;
+
+  const size_t seek0 = m_Seek;
+  m_Seek = m_ChunkIndex[chunks[0]].offset;
+
+  ChunkHeader header;
+  readChunkStart(header);
+  readWayNetData(info);
+  readChunkEnd();
+
+  m_Seek = seek0;
+  return true;
+  }
+
+size_t ZenParser::readVobSubtree(size_t chunk, zCVobData& vob, FileVersion version) {
+  const size_t seek0 = m_Seek;
+  m_Seek = m_ChunkIndex.at(chunk).offset;
+  const size_t num = readVobTree(vob,version);
+  m_Seek = seek0;
+  return num;
+  }
+
+void ZenParser::readVobsOfClass(ZenClass classId, std::vector<zCVobData>& vobs, FileVersion version) {
+  const size_t seek0 = m_Seek;
+  for(size_t i:findChunks(classId)) {
+    m_Seek = m_ChunkIndex[i].offset;
+
+    ChunkHeader header;
+    if(!readChunkStart(header))
+      continue;
+    zCVobData vob;
+    vob.vobName     = std::move(header.name);
+    vob.vobType     = zCVobData::VT_Unknown;
+    vob.vobObjectID = header.objectID;
+    zCVob::readObjectData(vob, *this, header, version);
+    vobs.emplace_back(std::move(vob));
+    }
+  m_Seek = seek0;
   }
 
 void ZenParser::readLightPresets(std::vector<zCVobData>& vobs, ZenParser::FileVersion version) {
@@ -477,10 +780,16 @@ void ZenParser::readCameras(std::vector<ZenLoad::zCVobData>& vobs, ZenParser::Fi
 size_t ZenParser::readVobTree(zCVobData& vob, FileVersion version) {
   ZenParser::ChunkHeader header = {};
   readChunkStart(header);
+
+  // The filter gets to see the name before it's moved into the vob
+  const bool accepted = !m_VobFilter || m_VobFilter(header);
   vob.vobName     = std::move(header.name);
   vob.vobType     = zCVobData::VT_Unknown;
   vob.vobObjectID = header.objectID;
-  zCVob::readObjectData(vob, *this, header, version);
+  if(accepted)
+    zCVob::readObjectData(vob, *this, header, version);
+  else
+    skipChunk();
 
   uint32_t numChildren = 0;
   getImpl()->readEntry("", numChildren);
@@ -492,32 +801,211 @@ size_t ZenParser::readVobTree(zCVobData& vob, FileVersion version) {
   return num+1;
   }
 
+/**
+  * @brief Reads a vob and all of its children like readVobTree(), but passes them to the visitor
+  *        instead of keeping them
+  */
+size_t ZenParser::visitVobTree(Visitor& visitor, FileVersion version) {
+  ChunkHeader header;
+  readChunkStart(header);
+
+  {
+  zCVobData vob;
+  vob.vobName     = header.name;
+  vob.vobType     = zCVobData::VT_Unknown;
+  vob.vobObjectID = header.objectID;
+  if(!m_VobFilter || m_VobFilter(header))
+    zCVob::readObjectData(vob, *this, header, version);
+  else
+    skipChunk();
+  visitor.onVobBegin(header,vob);
+  }
+
+  uint32_t numChildren = 0;
+  getImpl()->readEntry("", numChildren);
+
+  size_t num = 0;
+  for(uint32_t i = 0; i < numChildren; i++)
+    num += visitVobTree(visitor, version);
+  visitor.onVobEnd(header);
+  return num+1;
+  }
+
+/**
+  * @brief Reads a vob and all of its children into the flat arena-form, depth-first
+  */
+size_t ZenParser::readVobTree(ArenaWorldData& info, zCVobData& scratch, ChunkHeader& header,
+                              uint32_t parent, FileVersion version) {
+  const size_t offset = m_Seek;
+  readChunkStart(header);
+
+  // Only reset what gets copied below, readObjectData doesn't set all of it for every class
+  scratch.vobName     = header.name;
+  scratch.vobType     = zCVobData::VT_Unknown;
+  scratch.vobObjectID = header.objectID;
+  scratch.visual.clear();
+  scratch.presetName.clear();
+  scratch.bbox[0]     = {};
+  scratch.bbox[1]     = {};
+  scratch.position    = {};
+  scratch.worldMatrix = ZMath::Matrix::CreateIdentity();
+  scratch.showVisual  = false;
+  scratch.cdStatic    = false;
+  scratch.cdDyn       = false;
+  scratch.staticVob   = false;
+  if(!m_VobFilter || m_VobFilter(header))
+    zCVob::readObjectData(scratch, *this, header, version);
+  else
+    skipChunk();
+
+  const uint32_t self = uint32_t(info.vobs.size());
+  ArenaVobData   vob;
+  vob.offset      = offset;
+  vob.classId     = header.classId;
+  vob.vobType     = scratch.vobType;
+  vob.vobObjectID = scratch.vobObjectID;
+  vob.parent      = parent;
+  vob.vobName     = info.arena.store(scratch.vobName);
+  vob.visual      = info.arena.store(scratch.visual);
+  vob.presetName  = info.arena.store(scratch.presetName);
+  vob.bbox[0]     = scratch.bbox[0];
+  vob.bbox[1]     = scratch.bbox[1];
+  vob.position    = scratch.position;
+  vob.worldMatrix = scratch.worldMatrix;
+  vob.showVisual  = scratch.showVisual;
+  vob.cdStatic    = scratch.cdStatic;
+  vob.cdDyn       = scratch.cdDyn;
+  vob.staticVob   = scratch.staticVob;
+  info.vobs.push_back(vob);
+
+  uint32_t numChildren = 0;
+  getImpl()->readEntry("", numChildren);
+
+  size_t num = 0;
+  for(uint32_t i = 0; i < numChildren; i++)
+    num += readVobTree(info, scratch, header, self, version);
+
+  info.vobs[self].numChildren = numChildren;
+  info.vobs[self].subtreeSize = uint32_t(num+1);
+  return num+1;
+  }
+
+ZenParser::VobFilter ZenParser::filterByClass(std::initializer_list<ZenClass> classes) {
+  std::vector<bool> accept;
+  for(auto c:classes) {
+    if(size_t(c)>=accept.size())
+      accept.resize(size_t(c)+1);
+    accept[size_t(c)] = true;
+    }
+  return [accept](const ChunkHeader& header) {
+    return size_t(header.classId)<accept.size() && accept[size_t(header.classId)];
+    };
+  }
+
+/**
+  * @brief Skips a vob and all of its children
+  */
+void ZenParser::skipVobTree() {
+  ZenParser::ChunkHeader header = {};
+  if(!readChunkStart(header))
+    throw std::runtime_error("Expected vob-chunk not found!");
+  skipChunk();
+
+  uint32_t numChildren = 0;
+  getImpl()->readEntry("", numChildren);
+  for(uint32_t i=0; i<numChildren; i++)
+    skipVobTree();
+  }
+
+/**
+  * @brief Finds where each of the given subtrees starts, then parses them on several threads.
+  *        Every thread has its own parser on top of the same data.
+  */
+size_t ZenParser::readVobTreeParallel(std::vector<zCVobData>& vobs, FileVersion version) {
+  std::vector<size_t> starts(vobs.size());
+  for(size_t i=0; i<vobs.size(); ++i) {
+    starts[i] = m_Seek;
+    skipVobTree();
+    }
+  const size_t end = m_Seek;
+
+  std::atomic<size_t> next{0};
+  std::vector<size_t> counts(vobs.size());
+  std::mutex          errorSync;
+  std::exception_ptr  error;
+
+  auto worker = [&]() {
+    try {
+      ZenParser   parser(m_Data, m_DataSize);
+      ParserImpl* impl = nullptr;
+      parser.readHeader(parser.m_Header, impl);
+      std::unique_ptr<ParserImpl> owner(impl);
+      parser.setImpl(impl);
+      parser.m_VobFilter = m_VobFilter;  // One copy per worker, see setVobFilter()
+
+      for(size_t i=next++; i<vobs.size(); i=next++) {
+        parser.setSeek(starts[i]);
+        counts[i] = parser.readVobTree(vobs[i],version);
+        }
+      }
+    catch(...) {
+      std::lock_guard<std::mutex> guard(errorSync);
+      if(!error)
+        error = std::current_exception();
+      next = vobs.size();
+      }
+    };
+
+  const size_t numThreads = std::min(m_VobTreeThreads, vobs.size());
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads-1);
+  for(size_t i=1; i<numThreads; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for(auto& t:threads)
+    t.join();
+  if(error)
+    std::rethrow_exception(error);
+
+  m_Seek = end;
+  size_t num = 0;
+  for(auto c:counts)
+    num += c;
+  return num;
+  }
+
 void ZenParser::readWayNetData(zCWayNetData& info) {
+  internal::WayNetCollector collector(info);
+  info.waynetVersion = readWayNetData(collector);
+  }
+
+uint32_t ZenParser::readWayNetData(Visitor& visitor) {
   ZenParser::ChunkHeader waynetHeader;
   readChunkStart(waynetHeader);
 
+  uint32_t waynetVersion = 0;
   ReadObjectProperties(*this,
-                       Prop("waynetVersion", info.waynetVersion));
+                       Prop("waynetVersion", waynetVersion));
 
-  if(info.waynetVersion == 0) {
+  if(waynetVersion == 0) {
     // TODO: Implement old waynet format
     LogWarn() << "Old waynet-format not yet supported!";
-    return;
+    return waynetVersion;
     }
 
   uint32_t numWaypoints = 0;
   getImpl()->readEntry("numWaypoints", numWaypoints);
 
+  size_t numRead = 0;
   std::unordered_map<uint32_t, size_t> wpRefMap;
   for(uint32_t i = 0; i < numWaypoints; i++) {
     ZenParser::ChunkHeader wph;
     readChunkStart(wph);
-    zCWaypointData w = readWaypoint();
-    info.waypoints.push_back(w);
+    visitor.onWaypoint(numRead, readWaypoint());
     readChunkEnd();
 
     // Save for later access
-    wpRefMap[wph.objectID] = info.waypoints.size() - 1;
+    wpRefMap[wph.objectID] = numRead++;
     }
 
   // Then, the edges (ways)
@@ -540,20 +1028,20 @@ void ZenParser::readWayNetData(zCWayNetData& info) {
         } 
       else if(wph.classId==zCWaypoint) {
         // Create new waypoint
-        zCWaypointData w = readWaypoint();
-        info.waypoints.push_back(w);
+        visitor.onWaypoint(numRead, readWaypoint());
 
         // Save for later access
-        wpRefMap[wph.objectID] = info.waypoints.size() - 1;
-        *tgt = info.waypoints.size() - 1;
+        wpRefMap[wph.objectID] = numRead;
+        *tgt = numRead++;
         }
 
       readChunkEnd();
       tgt = &wp2;
       }
-    info.edges.emplace_back(wp1, wp2);
+    visitor.onEdge(wp1, wp2);
     }
   readChunkEnd();
+  return waynetVersion;
   }
 
 zCWaypointData ZenParser::readWaypoint() {
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iosfwd>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -10,6 +13,7 @@
 #include "utils/mathlib.h"
 #include "utils/split.h"
 #include "zCMesh.h"
+#include "vdfs/fileView.h"
 
 namespace VDFS
 {
@@ -20,6 +24,8 @@ namespace ZenLoad
 {
 class ParserImpl;
 class zCMesh;
+struct ArenaVobData;
+struct ArenaWorldData;
 
 class ZenParser
   {
@@ -157,6 +163,20 @@ public:
     ZenClass    classId = ZenClass::zUnknown;
     };
 
+  /**
+     * @brief Where to find one chunk of the file, see buildChunkIndex()
+     */
+  struct ChunkIndexEntry
+    {
+    size_t      offset   = 0;  // Position of the chunk-start
+    size_t      size     = 0;  // Up to and including the chunk-end
+    ZenClass    classId  = ZenClass::zUnknown;
+    uint32_t    objectID = 0;
+    uint16_t    version  = 0;
+    uint32_t    parent   = uint32_t(-1);  // Index of the enclosing chunk, -1 on top-level
+    std::string name;
+    };
+
   /**
      * @brief File-Header for ZEN-Files
      */
@@ -197,11 +217,146 @@ public:
    */
   void readHeader();
 
+  /**
+   * @brief Keeps only the given amount of already parsed bytes in memory, so huge zens don't stay resident
+   *        while being parsed. Only has an effect for files mapped from a VDFS::FileIndex. 0 disables it.
+   *        Seeking back further than that stays possible, the data is read from disk again then.
+   */
+  void setStreamingWindow(size_t bytes) { m_StreamingWindow = bytes; }
+
+  /**
+   * @brief Decides whether a vob gets parsed, see setVobFilter()
+   */
+  using VobFilter = std::function<bool(const ChunkHeader& header)>;
+
+  /**
+   * @brief Only vobs the filter accepts are parsed by readWorld(), all others are skipped without decoding
+   *        their properties. Skipped vobs stay in the tree with vobType VT_Unknown, so their children,
+   *        which are still read, keep their place. Pass an empty filter to read everything again.
+   *        With setVobTreeThreads(), every worker calls its own copy of the filter, concurrently and in no
+   *        particular order, so it must not keep state between calls nor touch shared data without locking.
+   */
+  void setVobFilter(VobFilter filter) { m_VobFilter = std::move(filter); }
+
+  /**
+   * @brief Filter accepting only the given classes
+   */
+  static VobFilter filterByClass(std::initializer_list<ZenClass> classes);
+
+  /**
+   * @brief Parses the root vobs of the VobTree on the given number of threads in readWorld(). 0 or 1 parse
+   *        everything on the calling thread. Log-callbacks and copies of the vob-filter, see setVobFilter(),
+   *        may then be called from several threads at once.
+   */
+  void setVobTreeThreads(size_t numThreads) { m_VobTreeThreads = numThreads; }
+
+  /**
+   * @brief Number of threads the world-mesh is decoded with, see zCMesh::setNumThreads(). The world-mesh
+   *        keeps the setting, so it applies to packing it, too.
+   */
+  void setWorldMeshThreads(size_t numThreads) { m_WorldMeshThreads = numThreads; }
+
   /**
    * @brief reads the main oCWorld-Object, found in the level-zens
    */
   void readWorld(oCWorldData& info, FileVersion version);
 
+  /**
+   * @brief Receives the objects of a world one by one, see readWorld(Visitor&, FileVersion)
+   */
+  class Visitor
+    {
+    public:
+    virtual ~Visitor() = default;
+
+    /**
+     * @brief A vob was read. Its children follow until the matching onVobEnd(). The data is only
+     *        valid during the call. Vobs rejected by the vob-filter are passed with vobType VT_Unknown.
+     */
+    virtual void onVobBegin(const ChunkHeader& /*header*/, const zCVobData& /*vob*/) {}
+    virtual void onVobEnd  (const ChunkHeader& /*header*/) {}
+
+    /**
+     * @brief A waypoint was read, index counts up from 0 in the order of the calls
+     */
+    virtual void onWaypoint(size_t /*index*/, const zCWaypointData& /*wp*/) {}
+
+    /**
+     * @brief A way between two waypoints, always after both of them were passed to onWaypoint()
+     */
+    virtual void onEdge(size_t /*wp1*/, size_t /*wp2*/) {}
+
+    /**
+     * @brief The world-mesh was read, it stays available through getWorldMesh()
+     */
+    virtual void onWorldMesh(const zCBspTreeData& /*bsp*/) {}
+    };
+
+  /**
+   * @brief reads the main oCWorld-Object like readWorld(oCWorldData&, FileVersion), but hands every object
+   *        to the visitor as soon as it is read instead of building the vob-tree. Always runs on the
+   *        calling thread, in file order.
+   */
+  void readWorld(Visitor& visitor, FileVersion version);
+
+  /**
+   * @brief reads the main oCWorld-Object into a flat, arena-backed form (see worldArena.h). Only the
+   *        properties all vobs share are kept. Class-specific ones (items, mobs, triggers, lights, sounds, ...)
+   *        are skipped and have to be read with readVob() from this file, which allocates per vob like
+   *        readWorld(oCWorldData&, FileVersion) does. Always runs on the calling thread.
+   */
+  void readWorld(ArenaWorldData& info, FileVersion version);
+
+  /**
+   * @brief Reads all properties of a vob of an ArenaWorldData parsed from this file, without its children.
+   *        Leaves the seek untouched.
+   */
+  void readVob(const ArenaVobData& arenaVob, zCVobData& vob, FileVersion version);
+
+  /**
+   * @brief Walks the whole file once and records where each chunk starts and ends, so parts of it can be
+   *        read without parsing everything in front of them. Must be called after readHeader().
+   *        Leaves the seek untouched. Throws for BINARY archives, their entries can't be skipped without
+   *        knowing what they are.
+   */
+  const std::vector<ChunkIndexEntry>& buildChunkIndex();
+  const std::vector<ChunkIndexEntry>& getChunkIndex() const { return m_ChunkIndex; }
+
+  /**
+   * @brief Stores the chunk-index, so it can be loaded again instead of building it
+   */
+  bool writeChunkIndex(std::ostream& out) const;
+
+  /**
+   * @return false if the stream doesn't hold a valid chunk-index for a file of this size
+   */
+  bool readChunkIndex(std::istream& in);
+
+  /**
+   * @return indices of all chunks of the given class / with the given name in the chunk-index
+   */
+  std::vector<size_t> findChunks(ZenClass classId) const;
+  std::vector<size_t> findChunks(const std::string& name) const;
+
+  /**
+   * @brief Reads just the waynet, using the chunk-index. Leaves the seek untouched.
+   * @return false if the index has no waynet
+   */
+  bool readWayNet(zCWayNetData& info);
+
+  /**
+   * @brief Reads the vob at the given chunk and all of its children, using the chunk-index.
+   *        The chunk must be a vob inside the VobTree. Leaves the seek untouched.
+   * @return number of vobs read
+   */
+  size_t readVobSubtree(size_t chunk, zCVobData& vob, FileVersion version);
+
+  /**
+   * @brief Reads all vobs of the given class, without their children, using the chunk-index.
+   *        Leaves the seek untouched.
+   */
+  void readVobsOfClass(ZenClass classId, std::vector<zCVobData>& vobs, FileVersion version);
+
   void readLightPresets(std::vector<zCVobData>& vobs, FileVersion version);
   void readLensFlares  (std::vector<zCVobData>& vobs, FileVersion version);
   void readCameras     (std::vector<zCVobData>& vobs, FileVersion version);
@@ -337,6 +492,21 @@ public:
   void skipEntry();
 
 private:
+  /**
+   * @brief What the readWorld()-overloads do with the chunks of a world, see readWorldChunks()
+   */
+  struct WorldChunkVisitor
+    {
+    std::function<void()>         onWorldMesh;  // Reads the MeshAndBsp-chunk, its start is already read
+    std::function<void(uint32_t)> onVobTree;    // Reads the given number of root vobs of the VobTree-chunk
+    std::function<void()>         onWayNet;     // Reads the WayNet-chunk, its start is already read
+    };
+
+  /**
+   * @brief Reads the oCWorld-chunk and hands its chunks to the visitor. Closes the chunks the visitor read.
+   */
+  void readWorldChunks(const WorldChunkVisitor& visitor);
+
   /**
    * @brief Skips the main header
    */
@@ -345,11 +515,22 @@ private:
   /**
     * @brief reads the worldmesh-chunk
     */
-  void           readWorldMesh (oCWorldData& info);
+  void           readWorldMesh (zCBspTreeData& bsp);
   size_t         readVobTree   (zCVobData& vob, FileVersion version);
+  size_t         visitVobTree  (Visitor& visitor, FileVersion version);
+  size_t         readVobTree   (ArenaWorldData& info, zCVobData& scratch, ChunkHeader& header,
+                                uint32_t parent, FileVersion version);
+  size_t         readVobTreeParallel(std::vector<zCVobData>& vobs, FileVersion version);
+  void           skipVobTree   ();
   void           readWayNetData(zCWayNetData& info);
+  uint32_t       readWayNetData(Visitor& visitor);
   zCWaypointData readWaypoint  ();
 
+  /**
+    * @brief Drops the parsed bytes behind the streaming window
+    */
+  void           releaseConsumed();
+
   /**
    * @brief Implementation this archive usese
    */
@@ -358,16 +539,38 @@ private:
   /**
    * @brief Data currently loaded and the current stream position
    */
-  std::vector<uint8_t>     m_DataStorage;
+  VDFS::FileView           m_DataStorage;
   const uint8_t*           m_Data=nullptr;
   size_t                   m_DataSize=0;
   size_t                   m_Seek=0;
 
+  /**
+   * @brief Parsed bytes to keep resident and how much was already dropped
+   */
+  size_t                   m_StreamingWindow=0;
+  size_t                   m_ReleasedUpTo=0;
+
+  /**
+   * @brief Threads used to parse the VobTree and which of its vobs to parse
+   */
+  size_t                   m_VobTreeThreads=0;
+  VobFilter                m_VobFilter;
+
+  /**
+   * @brief Threads used to decode the world-mesh
+   */
+  size_t                   m_WorldMeshThreads=0;
+
   /**
    * @brief ZEN-Header of the loaded file
    */
   ZenHeader                m_Header = {};
 
+  /**
+    * @brief Offsets of all chunks, filled by buildChunkIndex() or readChunkIndex()
+    */
+  std::vector<ChunkIndexEntry> m_ChunkIndex;
+
   /**
     * @brief The world mesh. Only non-null if the ZEN had one. (BinSave don't have a worldmesh)
     */
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "entryReader.h"
 #include "parserImpl.h"
 #include "zenParser.h"
 
@@ -96,6 +97,15 @@ namespace ZenLoad
     (void)x;
   }
 
+  /**
+    * @brief Same as above, through an EntryReader of a known archive-format
+    */
+  template <class Impl, typename... T>
+  static void ReadObjectProperties(EntryReader<Impl>& rd, std::pair<const char*, T*>... d)
+  {
+    (rd.readEntry(d.first, *d.second), ...);
+  }
+
   template <typename S>
   static std::pair<const char*, S*> Prop(const char* t, S& s)
   {